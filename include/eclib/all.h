@@ -19,9 +19,15 @@
 
 // Memory management
 #include "men.h"
+#include "arena.h"
+#include "pool.h"
 
 // Utilities
 #include "utils.h"
+#include "hashmap.h"
+#include "intern.h"
+#include "sort.h"
+#include "compress.h"
 #include "rui.h"
 
 // POSIX-like extensions for porting
@@ -0,0 +1,94 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef ECLIB_ARENA_H
+#define ECLIB_ARENA_H
+#include "error.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// ---------------------
+// Region allocator
+// ---------------------
+// An arena hands out memory by bumping a pointer through chunks it maps
+// from memory_manager. Nothing is freed individually: roll back to a mark,
+// reset, or destroy the arena. Chunks are kept across reset/rollback and
+// reused, so a request loop that resets its arena makes no IPC at all
+// once warmed up. An arena is not thread-safe.
+
+#define ECLIB_ARENA_DEFAULT_CHUNK  (64 * 1024)
+
+typedef struct eclib_arena_chunk eclib_arena_chunk_t;
+
+typedef struct {
+    eclib_arena_chunk_t* first;
+    eclib_arena_chunk_t* cur;   // chunk being bumped through
+    char* ptr;
+    char* end;
+    size_t chunk_size;
+} eclib_arena_t;
+
+// Checkpoint returned by eclib_arena_mark
+typedef struct {
+    eclib_arena_chunk_t* chunk;
+    char* ptr;
+} eclib_arena_mark_t;
+
+/*
+ * Initialise an empty arena (no memory is mapped until the first alloc)
+ * Parameters:
+ *   arena: Arena to initialise
+ *   chunk_size: Size of each backing chunk, 0 for ECLIB_ARENA_DEFAULT_CHUNK
+ */
+void eclib_arena_init(eclib_arena_t* arena, size_t chunk_size);
+
+/*
+ * Give every chunk back to memory_manager. The arena may be reused after.
+ */
+void eclib_arena_destroy(eclib_arena_t* arena);
+
+/*
+ * Allocate from the arena
+ * Return:
+ *   16-byte aligned memory, or NULL (and sets the last error code)
+ */
+void* eclib_arena_alloc(eclib_arena_t* arena, size_t size);
+void* eclib_arena_alloc_aligned(eclib_arena_t* arena, size_t size, size_t align);
+void* eclib_arena_calloc(eclib_arena_t* arena, size_t nmemb, size_t size);
+
+/*
+ * Checkpoints: everything allocated after eclib_arena_mark is released by
+ * eclib_arena_rollback. Marks must be rolled back in LIFO order.
+ */
+eclib_arena_mark_t eclib_arena_mark(const eclib_arena_t* arena);
+void eclib_arena_rollback(eclib_arena_t* arena, eclib_arena_mark_t mark);
+
+/*
+ * Release everything at once in O(1); the chunks stay mapped for reuse
+ */
+void eclib_arena_reset(eclib_arena_t* arena);
+
+/*
+ * Give the chunks that reset/rollback left idle back to memory_manager
+ * Return: Number of bytes released
+ */
+size_t eclib_arena_trim(eclib_arena_t* arena);
+
+/*
+ * Whether p points into one of the arena's chunks (walks the chunk list)
+ */
+int eclib_arena_owns(const eclib_arena_t* arena, const void* p);
+
+// Arena-backed counterparts of eclib_strdup
+char* eclib_arena_strdup(eclib_arena_t* arena, const char* s);
+char* eclib_arena_strndup(eclib_arena_t* arena, const char* s, size_t n);
+void* eclib_arena_memdup(eclib_arena_t* arena, const void* src, size_t len);
+
+#endif // ECLIB_ARENA_H
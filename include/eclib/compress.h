@@ -0,0 +1,181 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef ECLIB_COMPRESS_H
+#define ECLIB_COMPRESS_H
+#include "error.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// ---------------------
+// Compression
+// ---------------------
+// A byte-aligned LZ77 codec in the LZ4 block format: every sequence is a
+// token byte (literal count, match length), the literals, and a 16-bit
+// offset back into the last 64 KiB. There is no entropy stage, so both
+// directions run at memory-copy speeds and decompression never needs more
+// than the output buffer. Blocks made here decode with any LZ4 block
+// decoder and the other way round.
+//
+// A dictionary is data both sides already have (a template IPC message, a
+// previous state file); matches may point into its last 64 KiB, which is
+// what makes small repetitive payloads compress at all. Prepare it once
+// with eclib_zdict_init.
+//
+// The frame functions wrap blocks for streams of any length: a header, a
+// run of independent blocks of up to 64 KiB (stored raw when they do not
+// shrink) and optional CRC-32C checksums per block and over the content.
+
+#define ECLIB_ZBLOCK_MAX            (64 * 1024)     // Frame block size
+
+// Frame flags
+#define ECLIB_Z_BLOCK_CHECKSUM      0x01 // CRC-32C after every block
+#define ECLIB_Z_CONTENT_CHECKSUM    0x02 // CRC-32C of all data at the end
+
+#define ECLIB_ZDICT_HASH_LOG        12
+
+typedef struct {
+    const uint8_t* data;        // last 64 KiB of the caller's buffer
+    size_t len;
+    uint32_t id;                // CRC-32C of data, recorded in frames
+    uint32_t table[1 << ECLIB_ZDICT_HASH_LOG];
+} eclib_zdict_t;
+
+/*
+ * Largest compressed size of len bytes
+ * Return: Size to give eclib_compress so that it cannot run out of room
+ */
+static inline size_t eclib_compress_bound(size_t len) {
+    return len + len / 255 + 16;
+}
+
+/*
+ * Compress one block
+ * Parameters:
+ *   src, len: Data to compress (at most 2 GiB)
+ *   dst, cap: Output buffer
+ *   out_len: Receives the compressed size
+ * Return: ECLIB_OK, or ECLIB_ECLIB_BUFFER_TOO_SMALL when the result does
+ *         not fit in cap (never with cap >= eclib_compress_bound(len))
+ */
+eclib_err_t eclib_compress(const void* src, size_t len,
+                           void* dst, size_t cap, size_t* out_len);
+
+/*
+ * Decompress one block. The input is checked; damaged data is an error,
+ * never a read or write outside the buffers.
+ * Parameters:
+ *   src, len: Compressed block
+ *   dst, cap: Output buffer, at least the original size
+ *   out_len: Receives the decompressed size
+ * Return: ECLIB_OK, ECLIB_ECLIB_CORRUPT_DATA, or
+ *         ECLIB_ECLIB_BUFFER_TOO_SMALL
+ */
+eclib_err_t eclib_decompress(const void* src, size_t len,
+                             void* dst, size_t cap, size_t* out_len);
+
+/*
+ * Prepare a dictionary. Only its last 64 KiB are used and they are not
+ * copied: data must stay unchanged while dict is in use.
+ */
+void eclib_zdict_init(eclib_zdict_t* dict, const void* data, size_t len);
+
+/*
+ * eclib_compress / eclib_decompress with a dictionary. The same data must
+ * be given to both sides.
+ */
+eclib_err_t eclib_compress_dict(const void* src, size_t len,
+                                void* dst, size_t cap, size_t* out_len,
+                                const eclib_zdict_t* dict);
+eclib_err_t eclib_decompress_dict(const void* src, size_t len,
+                                  void* dst, size_t cap, size_t* out_len,
+                                  const eclib_zdict_t* dict);
+
+// --------------------------
+// Frames
+// --------------------------
+typedef struct {
+    eclib_sink_fn sink;
+    void* ctx;
+    const eclib_zdict_t* dict;
+    uint32_t flags;
+    uint32_t content_crc;
+    uint8_t* in;                // ECLIB_ZBLOCK_MAX bytes being collected
+    size_t in_len;
+    uint8_t* out;               // header + compressed block + checksum
+    eclib_err_t err;            // first failure, sticky
+} eclib_zwriter_t;
+
+typedef struct {
+    const eclib_zdict_t* dict;
+    uint32_t flags;
+    uint32_t content_crc;
+    int state;
+    uint32_t block;             // header of the block being read
+    size_t need;                // bytes the current state waits for
+    size_t have;                // of those, gathered in buf so far
+    uint8_t* buf;               // compressed block being collected
+    uint8_t* out;               // decompressed block
+    eclib_err_t err;
+} eclib_zreader_t;
+
+/*
+ * Start a frame; the header goes to sink right away
+ * Parameters:
+ *   w: Writer to initialise
+ *   sink, ctx: Receives the compressed frame piece by piece
+ *   flags: ECLIB_Z_* flags
+ *   dict: Dictionary for every block, or NULL
+ * Return: ECLIB_OK or ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY
+ */
+eclib_err_t eclib_zwriter_init(eclib_zwriter_t* w, eclib_sink_fn sink,
+                               void* ctx, uint32_t flags,
+                               const eclib_zdict_t* dict);
+
+/*
+ * Add data to the frame. Full blocks are compressed and passed on as
+ * they fill up.
+ */
+eclib_err_t eclib_zwriter_write(eclib_zwriter_t* w, const void* data,
+                                size_t len);
+
+/*
+ * Flush the last block, end the frame and free the buffers
+ * Return: ECLIB_OK, or the first error met while writing
+ */
+eclib_err_t eclib_zwriter_finish(eclib_zwriter_t* w);
+
+/*
+ * Start reading a frame
+ * Parameters:
+ *   r: Reader to initialise
+ *   dict: The writer's dictionary, or NULL
+ */
+void eclib_zreader_init(eclib_zreader_t* r, const eclib_zdict_t* dict);
+
+/*
+ * Feed compressed bytes, in pieces of any size. Decompressed data goes
+ * to sink a block at a time.
+ * Return: ECLIB_OK, ECLIB_ECLIB_CORRUPT_DATA (bad header, block or
+ *         checksum, data after the end, or a dictionary mismatch) or
+ *         ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY
+ */
+eclib_err_t eclib_zreader_feed(eclib_zreader_t* r, const void* data,
+                               size_t len, eclib_sink_fn sink, void* ctx);
+
+/*
+ * Free the buffers
+ * Return: ECLIB_OK if the whole frame was read, otherwise
+ *         ECLIB_ECLIB_CORRUPT_DATA (truncated) or the feed error
+ */
+eclib_err_t eclib_zreader_finish(eclib_zreader_t* r);
+
+#endif
@@ -11,10 +11,71 @@
 #ifndef ECLIB_ENV_H
 #define ECLIB_ENV_H
 
+#include "arena.h"
+#include <stddef.h>
+
 extern char** eclib_environ;
 
+// The array and the entries setenv adds are owned by the library.
+// eclib_getenv, eclib_setenv and eclib_unsetenv may be called from any
+// thread. A value returned by eclib_getenv is not covered by the
+// snapshot reclamation below: it stays valid only until the environment
+// is next changed, by any thread. The same holds for the entries of
+// eclib_environ. Code that keeps values while other threads write should
+// hold a snapshot instead. Unsetting moves the last entry into the freed
+// slot, so the order of eclib_environ is not preserved.
 char* eclib_getenv(const char* name);
 int eclib_setenv(const char* name, const char* value, int overwrite);
 int eclib_unsetenv(const char* name);
+// eclib_getenv finds names through an index that notices a new array or
+// length in eclib_environ by itself. Code that stores a different
+// variable into an existing slot should call this afterwards.
+void eclib_env_invalidate(void);
+
+// ---------------------
+// Snapshots
+// ---------------------
+// An immutable copy of the environment that readers on any thread can
+// use without taking a lock. Holding one costs a store to a per-thread
+// record; writers publish a new copy and free the old one only once no
+// thread holds it. The first snapshot after a change makes the new copy,
+// so setting many variables in a row costs one copy.
+
+typedef struct eclib_env_snapshot eclib_env_snapshot_t;
+
+/*
+ * Get the current snapshot. Calls may nest; each needs its release.
+ * Return: The snapshot, or NULL (and sets the last error code) if the
+ *         first one cannot be allocated
+ */
+const eclib_env_snapshot_t* eclib_env_snapshot(void);
+
+/*
+ * Stop using a snapshot. Nothing read from it may be used afterwards.
+ */
+void eclib_env_snapshot_release(const eclib_env_snapshot_t* snap);
+
+/*
+ * Value of name in a snapshot, or NULL if it is not set
+ */
+const char* eclib_env_snapshot_get(const eclib_env_snapshot_t* snap,
+                                   const char* name);
+
+/*
+ * NULL-terminated entries of a snapshot
+ * Parameters:
+ *   count: Set to the number of entries (may be NULL)
+ */
+char* const* eclib_env_snapshot_environ(const eclib_env_snapshot_t* snap,
+                                        size_t* count);
+
+// Arena-backed variants: results live until the arena is reset. They
+// read through a snapshot, so any thread may call them.
+// Copy of the value of name, or NULL if it is not set
+char* eclib_getenv_arena(eclib_arena_t* arena, const char* name);
+// Builds a "NAME=VALUE" entry, e.g. for an envp passed to eclib_execve
+char* eclib_env_entry_arena(eclib_arena_t* arena, const char* name, const char* value);
+// NULL-terminated copy of eclib_environ, entries included
+char** eclib_environ_dup_arena(eclib_arena_t* arena);
 
 #endif
@@ -80,6 +80,10 @@
 #define ECLIB_ECLIB_UNSUPPORTED_PLATFORM -3005 // Unsupported platform (ECLib not supported on this OS!)
 #define ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY -3006 // Cannot allocate memory (Out of memory during ECLib operation!)
 #define ECLIB_ECLIB_INVALID_OPERATION   -3007 // Invalid ECLib operation (Operation not allowed in current state!)
+#define ECLIB_ECLIB_OUT_OF_RANGE        -3008 // Value out of range (That number does not fit, clamped!)
+#define ECLIB_ECLIB_BUFFER_TOO_SMALL    -3009 // Output buffer too small (Give it more room!)
+#define ECLIB_ECLIB_CORRUPT_DATA        -3010 // Data is damaged or truncated (Checksum or format check failed!)
+#define ECLIB_ECLIB_INVALID_ENCODING    -3011 // Text is not valid UTF-8/UTF-16/UTF-32 (Mojibake incoming!)
 #define ECLIB_ECLIB_CANNOT_FIND_MODULE   0x100 // Cannot find
 #define ECLIB_ECLIB_INVALID_MODULE_STATE 0x101 // Invalid module state (Is the module initialized?)
 #define ECLIB_ECLIB_CANNOT_LOAD_LIBRARY  0x102 // Cannot load library (Shared library missing or corrupted!)
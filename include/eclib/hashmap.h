@@ -0,0 +1,138 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef ECLIB_HASHMAP_H
+#define ECLIB_HASHMAP_H
+#include "error.h"
+#include "arena.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// ---------------------
+// Hash map
+// ---------------------
+// Open addressing in the Swiss table layout: next to the entry array sits
+// one control byte per slot holding 7 bits of the key's hash (or empty /
+// deleted). A lookup compares 16 control bytes at once with SSE2 or NEON
+// and only touches entries whose byte matches, so a miss usually costs
+// one vector compare and a hit one key comparison. Tables stay at most
+// 7/8 full and double when they get there.
+//
+// Keys are either strings (pointer and length) or 64-bit integers, fixed
+// when the map is initialised. Values are a void*; point them at objects
+// from an eclib_pool_t when they are bigger than that. The table lives on
+// the heap, or in an arena (old tables then stay in the arena until it is
+// reset). A map is not thread-safe.
+
+// Map flags
+#define ECLIB_HASHMAP_STR        0x00 // String keys (default)
+#define ECLIB_HASHMAP_U64        0x01 // 64-bit integer keys
+#define ECLIB_HASHMAP_COPY_KEYS  0x02 // Keep a private copy of string keys
+
+typedef struct {
+    union {
+        const char* str;        // NUL-terminated when the map copies keys
+        uint64_t u64;
+    } key;
+    size_t len;                 // string keys: length without the NUL
+    void* value;
+} eclib_hashmap_entry_t;
+
+typedef struct {
+    uint8_t* ctrl;              // capacity + 16 control bytes
+    eclib_hashmap_entry_t* entries;
+    size_t capacity;            // power of two, 0 until the first insert
+    size_t size;
+    size_t growth_left;         // inserts before the table must be rebuilt
+    uint64_t seed;
+    uint32_t flags;
+    eclib_arena_t* arena;       // NULL: heap
+} eclib_hashmap_t;
+
+/*
+ * Initialise an empty map (nothing is allocated until the first insert)
+ * Parameters:
+ *   map: Map to initialise
+ *   flags: ECLIB_HASHMAP_* flags
+ *   arena: Arena for the table and key copies, NULL for the heap
+ */
+void eclib_hashmap_init(eclib_hashmap_t* map, uint32_t flags,
+                        eclib_arena_t* arena);
+
+/*
+ * Free the table and the key copies (heap maps only; an arena map just
+ * forgets them). The map may be reused after.
+ */
+void eclib_hashmap_destroy(eclib_hashmap_t* map);
+
+/*
+ * Remove every entry, keeping the table
+ */
+void eclib_hashmap_clear(eclib_hashmap_t* map);
+
+/*
+ * Make room for n entries in total so inserting them never rebuilds
+ * Return: ECLIB_OK or ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY
+ */
+eclib_err_t eclib_hashmap_reserve(eclib_hashmap_t* map, size_t n);
+
+static inline size_t eclib_hashmap_size(const eclib_hashmap_t* map) {
+    return map->size;
+}
+
+/*
+ * Look a key up
+ * Return: Its entry, or NULL. The entry stays valid until the next insert
+ * or erase.
+ */
+eclib_hashmap_entry_t* eclib_hashmap_find_strn(const eclib_hashmap_t* map,
+                                               const char* key, size_t len);
+eclib_hashmap_entry_t* eclib_hashmap_find_u64(const eclib_hashmap_t* map,
+                                              uint64_t key);
+
+/*
+ * Find a key, adding it with a NULL value if it is missing
+ * Parameters:
+ *   inserted: Set to 1 when the key was added, 0 when found (may be NULL)
+ * Return: Its entry, or NULL (and sets the last error code)
+ */
+eclib_hashmap_entry_t* eclib_hashmap_insert_strn(eclib_hashmap_t* map,
+                                                 const char* key, size_t len,
+                                                 int* inserted);
+eclib_hashmap_entry_t* eclib_hashmap_insert_u64(eclib_hashmap_t* map,
+                                                uint64_t key, int* inserted);
+
+/*
+ * Remove an entry returned by find/insert/next. Erasing while iterating
+ * is fine: the entry after it is still visited.
+ */
+void eclib_hashmap_erase(eclib_hashmap_t* map, eclib_hashmap_entry_t* entry);
+
+/*
+ * Iterate: start with *iter = 0 and call until it returns NULL. Order is
+ * unspecified, and inserting during iteration invalidates it.
+ */
+eclib_hashmap_entry_t* eclib_hashmap_next(const eclib_hashmap_t* map,
+                                          size_t* iter);
+
+// Value shorthands. get returns NULL for missing keys as well as NULL
+// values; use find to tell them apart.
+eclib_err_t eclib_hashmap_put_str(eclib_hashmap_t* map, const char* key,
+                                  void* value);
+void* eclib_hashmap_get_str(const eclib_hashmap_t* map, const char* key);
+int eclib_hashmap_remove_str(eclib_hashmap_t* map, const char* key,
+                             void** value);
+eclib_err_t eclib_hashmap_put_u64(eclib_hashmap_t* map, uint64_t key,
+                                  void* value);
+void* eclib_hashmap_get_u64(const eclib_hashmap_t* map, uint64_t key);
+int eclib_hashmap_remove_u64(eclib_hashmap_t* map, uint64_t key,
+                             void** value);
+
+#endif // ECLIB_HASHMAP_H
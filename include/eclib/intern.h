@@ -0,0 +1,52 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef ECLIB_INTERN_H
+#define ECLIB_INTERN_H
+#include <stdint.h>
+#include <stddef.h>
+
+// ---------------------
+// String interning
+// ---------------------
+// eclib_intern maps every distinct string to a small nonzero atom and one
+// canonical copy of it, both valid for the life of the process. Equal
+// strings give equal atoms, so names can be stored and compared as 4-byte
+// integers. Lookups take no lock; adding a new string takes a mutex.
+// Atoms are only meaningful inside the process that made them: messages
+// between processes still carry the names.
+
+typedef uint32_t eclib_atom_t;
+
+#define ECLIB_ATOM_NONE     0
+
+/*
+ * Intern a string (or str[0..len), which may contain NULs)
+ * Return: Its atom, or ECLIB_ATOM_NONE (and sets the last error code)
+ */
+eclib_atom_t eclib_intern(const char* str);
+eclib_atom_t eclib_intern_n(const char* str, size_t len);
+
+/*
+ * Find the atom of a string without adding it
+ * Return: Its atom, or ECLIB_ATOM_NONE if it was never interned
+ */
+eclib_atom_t eclib_atom_find(const char* str);
+eclib_atom_t eclib_atom_find_n(const char* str, size_t len);
+
+/*
+ * Canonical copy of an atom's string, NUL-terminated
+ * Parameters:
+ *   len: Set to its length (may be NULL)
+ * Return: The string, or NULL for an unknown atom
+ */
+const char* eclib_atom_str(eclib_atom_t atom, size_t* len);
+
+#endif // ECLIB_INTERN_H
@@ -22,6 +22,26 @@
 #define IPC_MSG_APPENDIX_S_WAIT    0x57414954  // "WAIT"
 #define IPC_MSG_APPENDIX_S_OKTHANKS 0x4F4B5448 // "OKTH"
 #define IPC_MSG_DO_NOT_KILL        0x444F4E54  // "DONT"
+#define IPC_MSG_MEMORY_PRESSURE    0x4D454D50  // "MEMP"
+#define IPC_MSG_MEMORY_TRIMMED     0x5452494D  // "TRIM"
+
+// Memory pressure levels carried by IPC_MSG_MEMORY_PRESSURE
+#define IPC_MEMORY_PRESSURE_LOW       1 // Drop idle caches
+#define IPC_MEMORY_PRESSURE_MODERATE  2 // Drop caches that are cheap to rebuild
+#define IPC_MEMORY_PRESSURE_CRITICAL  3 // Drop everything that can be dropped
+
+// IPC_MSG_MEMORY_PRESSURE payload (memory_manager -> process)
+typedef struct {
+    uint32_t level;          // IPC_MEMORY_PRESSURE_*
+    uint32_t reserved;
+} ipc_memory_pressure_t;
+
+// IPC_MSG_MEMORY_TRIMMED payload (process -> memory_manager)
+typedef struct {
+    uint32_t level;          // Level that was handled
+    uint32_t reserved;
+    uint64_t bytes_freed;    // Bytes given back to memory_manager
+} ipc_memory_trimmed_t;
 
 // IPC message structure
 typedef struct ipc_message {
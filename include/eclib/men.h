@@ -22,4 +22,153 @@ void* eclib_calloc(size_t nmemb, size_t size);
 
 void* eclib_realloc(void* ptr, size_t size);
 
+/*
+ * Number of bytes actually usable at addr (>= the size that was requested)
+ * Return: 0 if addr is NULL or was not returned by eclib_malloc
+ */
+size_t eclib_malloc_usable_size(void* addr);
+
+/*
+ * Free a block whose requested size is known to the caller.
+ * size must be the size the block was last allocated or reallocated with;
+ * it lets small frees skip the block header lookup.
+ */
+void eclib_free_sized(void* addr, size_t size);
+
+/*
+ * Allocate n blocks of the same size in as few round trips as possible
+ * Parameters:
+ *   n: Number of blocks
+ *   size: Size of each block
+ *   out: Receives the n block addresses
+ * Return:
+ *   n on success; 0 on failure (nothing is left allocated)
+ */
+size_t eclib_malloc_batch(size_t n, size_t size, void** out);
+
+/*
+ * Memory released by eclib_free is handed back to memory_manager in
+ * batches. Flush the calling thread's cache and every pending batch now.
+ */
+void eclib_free_flush(void);
+
+// --------------------------
+// Statistics and heap profiling
+// --------------------------
+// Counters are kept per thread and summed on demand, so they stay on in
+// production. On top of them, roughly one allocation per sample-rate bytes
+// is attributed to its call site (the caller's return address).
+
+#define ECLIB_MEM_STAT_CLASSES      33  // 32 small size classes + large blocks
+#define ECLIB_MEM_PROFILE_RATE      (512 * 1024)
+
+typedef struct {
+    uint32_t size;              // block size of the class, 0 for large blocks
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t live_bytes;
+    uint64_t peak_bytes;        // highest live_bytes seen at a sample or read
+} eclib_mem_class_stats_t;
+
+typedef struct {
+    eclib_mem_class_stats_t classes[ECLIB_MEM_STAT_CLASSES];
+    uint64_t allocs;            // all classes
+    uint64_t live_bytes;
+    uint64_t ipc_calls;         // round trips to memory_manager
+    uint64_t samples;
+    size_t sample_rate;
+} eclib_mem_stats_t;
+
+typedef struct {
+    void* site;                 // return address of the allocating call
+    uint64_t samples;
+    uint64_t bytes;             // bytes requested by the sampled calls
+} eclib_mem_site_t;
+
+void eclib_mem_get_stats(eclib_mem_stats_t* stats);
+
+/*
+ * Set the mean number of allocated bytes between two samples (0 = off).
+ * Each thread picks up the new rate at its next sample point.
+ */
+void eclib_mem_profile_set_rate(size_t bytes);
+size_t eclib_mem_profile_get_rate(void);
+
+/*
+ * Copy up to max call sites, heaviest first
+ * Return: Number of sites written
+ */
+size_t eclib_mem_profile_sites(eclib_mem_site_t* sites, size_t max);
+
+/*
+ * Write the statistics and every sampled site as line-oriented text:
+ *   eclib-heap-profile 1
+ *   rate <bytes> samples <n> ipc <n> allocs <n> live <bytes>
+ *   class <size> allocs <n> frees <n> live <bytes> peak <bytes>
+ *   site 0x<addr> samples <n> bytes <n>
+ * Return: Length of the full dump (output is truncated if >= size)
+ */
+size_t eclib_mem_profile_dump(char* buf, size_t size);
+
+// --------------------------
+// Memory pressure
+// --------------------------
+// memory_manager sends IPC_MSG_MEMORY_PRESSURE when the system runs low.
+// Every registered trim callback then runs, highest priority first, and
+// the bytes they report are sent back in IPC_MSG_MEMORY_TRIMMED. eclib
+// registers its own caches below ECLIB_MEM_TRIM_PRIO_DEFAULT, so memory
+// an application cache frees through eclib_free is returned in the same
+// pass.
+
+#define ECLIB_MEM_TRIM_MAX          32
+#define ECLIB_MEM_TRIM_PRIO_DEFAULT 100
+#define ECLIB_MEM_TRIM_PRIO_TCACHE  30  // per-thread caches
+#define ECLIB_MEM_TRIM_PRIO_HEAP    20  // empty runs kept for reuse
+#define ECLIB_MEM_TRIM_PRIO_PAGES   10  // pages waiting for a batched unmap
+
+/*
+ * Trim callback
+ * Parameters:
+ *   level: IPC_MEMORY_PRESSURE_*
+ *   user_data: Pointer given at registration
+ * Return: Number of bytes released
+ */
+typedef size_t (*eclib_mem_trim_fn)(uint32_t level, void* user_data);
+
+/*
+ * Register a trim callback
+ * Parameters:
+ *   fn: Callback
+ *   user_data: Passed to fn
+ *   priority: Higher runs earlier; ECLIB_MEM_TRIM_PRIO_DEFAULT if unsure
+ * Return:
+ *   ECLIB_OK, ECLIB_ECLIB_INVALID_PARAMETER, ECLIB_ECLIB_RESOURCE_LIMIT or
+ *   ECLIB_ECLIB_INVALID_OPERATION (already registered)
+ */
+eclib_err_t eclib_mem_register_trim(eclib_mem_trim_fn fn, void* user_data,
+                                    int priority);
+
+/*
+ * Remove a callback registered with the same fn and user_data
+ * Return: ECLIB_OK or ECLIB_ECLIB_CANNOT_FIND_RESOURCE
+ */
+eclib_err_t eclib_mem_unregister_trim(eclib_mem_trim_fn fn, void* user_data);
+
+/*
+ * Run every trim callback now
+ * Parameters:
+ *   level: IPC_MEMORY_PRESSURE_*
+ * Return: Total bytes released
+ */
+size_t eclib_mem_trim(uint32_t level);
+
+/*
+ * Handle an IPC_MSG_MEMORY_PRESSURE message from the receive loop: trims
+ * at the requested level and replies to the sender with the result.
+ * Return:
+ *   ECLIB_OK, ECLIB_ECLIB_INVALID_PARAMETER if msg is not a pressure
+ *   message, or ECLIB_IPC_SERVICE_UNAVAIL if the reply could not be sent
+ */
+eclib_err_t eclib_mem_handle_pressure(const ipc_message_t* msg);
+
 #endif
\ No newline at end of file
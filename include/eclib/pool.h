@@ -0,0 +1,109 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef ECLIB_POOL_H
+#define ECLIB_POOL_H
+#include "error.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+// ---------------------
+// Fixed-size object pool
+// ---------------------
+// Slots of one size are carved from slabs mapped from memory_manager and
+// recycled through a lock-free stack. Free slots are linked by 32-bit slot
+// index and the stack head carries a version tag next to the index, so a
+// slot popped and pushed back between another thread's read and CAS cannot
+// fool it (ABA). Slabs go back to memory_manager when the pool is
+// destroyed or when eclib_pool_trim finds every slot of one free.
+
+// Pool flags
+#define ECLIB_POOL_PACKED     0x01 // 16-byte slots instead of 64-byte cache lines
+#define ECLIB_POOL_MAGAZINES  0x02 // Per-thread magazines in front of the stack
+
+#define ECLIB_POOL_MAX_SLABS  1024
+
+typedef struct eclib_pool {
+    uint64_t head;              // (tag << 32) | (free slot index + 1)
+    uint64_t id;                // tells magazines of a dead pool apart
+    uint32_t flags;
+    uint32_t obj_size;
+    uint32_t slot_size;
+    uint32_t slots_per_slab;
+    uint32_t slot_div;          // 2^32 / slot_size, rounded up
+    uint32_t slab_count;
+    size_t slab_size;
+    char** slabs;
+    pthread_mutex_t grow_lock;
+} eclib_pool_t;
+
+/*
+ * Initialise a pool
+ * Parameters:
+ *   pool: Pool to initialise
+ *   obj_size: Size of every object
+ *   flags: ECLIB_POOL_* flags
+ * Return:
+ *   ECLIB_OK, ECLIB_ECLIB_INVALID_PARAMETER or ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY
+ */
+eclib_err_t eclib_pool_init(eclib_pool_t* pool, size_t obj_size, uint32_t flags);
+
+/*
+ * Give every slab back to memory_manager. All objects become invalid.
+ * With ECLIB_POOL_MAGAZINES, every other thread that used the pool must
+ * have called eclib_pool_thread_flush on it (or exited) before this.
+ */
+void eclib_pool_destroy(eclib_pool_t* pool);
+
+/*
+ * Take an (uninitialised) object from the pool
+ * Return: The object, or NULL (and sets the last error code)
+ */
+void* eclib_pool_alloc(eclib_pool_t* pool);
+
+/*
+ * Put an object back; obj must come from this pool
+ */
+void eclib_pool_free(eclib_pool_t* pool, void* obj);
+
+/*
+ * Give every slab whose slots are all free back to memory_manager.
+ * Other threads may free into the pool meanwhile but must not allocate
+ * from it (a racing pop could read a slab being unmapped). Slots sitting
+ * in magazines count as in use.
+ * Return: Number of bytes released
+ */
+size_t eclib_pool_trim(eclib_pool_t* pool);
+
+/*
+ * Return the calling thread's magazine for pool to the shared stack
+ */
+void eclib_pool_thread_flush(eclib_pool_t* pool);
+
+/*
+ * Typed wrappers, e.g.
+ *   ECLIB_POOL_DEFINE(event, rui_event_t)
+ * gives event_pool_init(), event_pool_alloc() returning rui_event_t* and
+ * event_pool_free().
+ */
+#define ECLIB_POOL_DEFINE(name, type)                                          \
+    static inline eclib_err_t name##_pool_init(eclib_pool_t* pool,             \
+                                               uint32_t flags) {               \
+        return eclib_pool_init(pool, sizeof(type), flags);                     \
+    }                                                                          \
+    static inline type* name##_pool_alloc(eclib_pool_t* pool) {                \
+        return (type*)eclib_pool_alloc(pool);                                  \
+    }                                                                          \
+    static inline void name##_pool_free(eclib_pool_t* pool, type* obj) {       \
+        eclib_pool_free(pool, obj);                                            \
+    }
+
+#endif // ECLIB_POOL_H
@@ -0,0 +1,308 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef ECLIB_SORT_H
+#define ECLIB_SORT_H
+#include "error.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// ---------------------
+// Sorting and searching
+// ---------------------
+// The comparison sorts are pattern-defeating quicksort: median-of-three
+// (ninther for big ranges) pivots, insertion sort below 24 elements, runs
+// of equal keys split off in one pass, already sorted input finished
+// in linear time, and after log2(n) badly unbalanced partitions the rest
+// is heap sorted, so the worst case stays O(n log n). None of them is
+// stable.
+//
+// eclib_qsort and friends take a comparator like the C library's. The
+// ECLIB_SORT_DEFINE templates generate code for one element type and an
+// inlinable "less" instead, which is several times faster for small
+// elements.
+
+typedef int (*eclib_cmp_fn)(const void* a, const void* b);
+typedef int (*eclib_cmp_r_fn)(const void* a, const void* b, void* ctx);
+
+/*
+ * Sort n elements of size bytes each in place
+ */
+void eclib_qsort(void* base, size_t n, size_t size, eclib_cmp_fn cmp);
+void eclib_qsort_r(void* base, size_t n, size_t size, eclib_cmp_r_fn cmp,
+                   void* ctx);
+
+/*
+ * Search a sorted array without data-dependent branches
+ * Return:
+ *   eclib_bsearch: An element equal to key, or NULL
+ *   eclib_lower_bound: Index of the first element not less than key (n if none)
+ */
+void* eclib_bsearch(const void* key, const void* base, size_t n, size_t size,
+                    eclib_cmp_fn cmp);
+size_t eclib_lower_bound(const void* key, const void* base, size_t n,
+                         size_t size, eclib_cmp_fn cmp);
+
+/*
+ * LSD radix sort of integer keys, 8 bits per pass. Passes in which every
+ * key has the same byte are skipped.
+ * Parameters:
+ *   tmp: Scratch space for n keys, or NULL to allocate it
+ * Return: ECLIB_OK or ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY
+ */
+eclib_err_t eclib_radix_sort_u32(uint32_t* a, size_t n, uint32_t* tmp);
+eclib_err_t eclib_radix_sort_u64(uint64_t* a, size_t n, uint64_t* tmp);
+
+/*
+ * Sort with up to threads threads: the array is cut into one run per
+ * thread, the runs are sorted at the same time, then merged pairwise with
+ * every merge split across the threads. Needs a scratch copy of the
+ * array; small arrays, threads <= 1 or a failed allocation fall back to
+ * eclib_qsort.
+ */
+void eclib_sort_parallel(void* base, size_t n, size_t size, eclib_cmp_fn cmp,
+                         unsigned threads);
+
+// ---------------------
+// Typed templates
+// ---------------------
+/*
+ *   ECLIB_SORT_DEFINE(u32, uint32_t, U32_LESS)
+ * with less(x, y) true when *x orders before *y (x and y are const type*)
+ * gives
+ *   void u32_sort(uint32_t* a, size_t n);
+ *   size_t u32_lower_bound(const uint32_t* a, size_t n, const uint32_t* key);
+ *   uint32_t* u32_bsearch(const uint32_t* a, size_t n, const uint32_t* key);
+ * ECLIB_SORT_DEFINE_R is the same with less(x, y, ctx) and a trailing
+ * void* ctx on each function, which are named with an _r suffix.
+ */
+#define ECLIB_SORT_DEFINE(name, type, less)                                    \
+    static inline int name##_less_ctx_(const type* x, const type* y,           \
+                                       void* ctx) {                            \
+        (void)ctx;                                                             \
+        return less(x, y);                                                     \
+    }                                                                          \
+    ECLIB_SORT_DEFINE_R(name, type, name##_less_ctx_)                          \
+    static inline void name##_sort(type* a, size_t n) {                        \
+        name##_sort_r(a, n, NULL);                                             \
+    }                                                                          \
+    static inline size_t name##_lower_bound(const type* a, size_t n,           \
+                                            const type* key) {                 \
+        return name##_lower_bound_r(a, n, key, NULL);                          \
+    }                                                                          \
+    static inline type* name##_bsearch(const type* a, size_t n,                \
+                                       const type* key) {                      \
+        return name##_bsearch_r(a, n, key, NULL);                              \
+    }
+
+#define ECLIB_SORT_INSERTION_MAX  24
+#define ECLIB_SORT_NINTHER_MIN    128
+
+#define ECLIB_SORT_DEFINE_R(name, type, less)                                  \
+    static inline void name##_sort_swap_(type* x, type* y) {                   \
+        type t = *x;                                                           \
+        *x = *y;                                                               \
+        *y = t;                                                                \
+    }                                                                          \
+    static inline void name##_sort_ins_(type* b, type* e, void* ctx) {         \
+        if (b == e) return;                                                    \
+        for (type* cur = b + 1; cur != e; cur++) {                             \
+            if (!less(cur, cur - 1, ctx)) continue;                            \
+            type t = *cur;                                                     \
+            type* s = cur;                                                     \
+            do {                                                               \
+                *s = *(s - 1);                                                 \
+                s--;                                                           \
+            } while (s != b && less(&t, s - 1, ctx));                          \
+            *s = t;                                                            \
+        }                                                                      \
+    }                                                                          \
+    /* Insertion sort that gives up after 8 moves; 1 if it finished */        \
+    static inline int name##_sort_try_ins_(type* b, type* e, void* ctx) {      \
+        if (b == e) return 1;                                                  \
+        size_t moved = 0;                                                      \
+        for (type* cur = b + 1; cur != e; cur++) {                             \
+            if (moved > 8) return 0;                                           \
+            if (!less(cur, cur - 1, ctx)) continue;                            \
+            type t = *cur;                                                     \
+            type* s = cur;                                                     \
+            do {                                                               \
+                *s = *(s - 1);                                                 \
+                s--;                                                           \
+            } while (s != b && less(&t, s - 1, ctx));                          \
+            *s = t;                                                            \
+            moved += (size_t)(cur - s);                                        \
+        }                                                                      \
+        return 1;                                                              \
+    }                                                                          \
+    static inline void name##_sort_sift_(type* a, size_t i, size_t n,          \
+                                         void* ctx) {                          \
+        type t = a[i];                                                         \
+        for (;;) {                                                             \
+            size_t c = 2 * i + 1;                                              \
+            if (c >= n) break;                                                 \
+            if (c + 1 < n && less(&a[c], &a[c + 1], ctx)) c++;                 \
+            if (!less(&t, &a[c], ctx)) break;                                  \
+            a[i] = a[c];                                                       \
+            i = c;                                                             \
+        }                                                                      \
+        a[i] = t;                                                              \
+    }                                                                          \
+    static inline void name##_sort_heap_(type* a, size_t n, void* ctx) {       \
+        for (size_t i = n / 2; i-- > 0;) name##_sort_sift_(a, i, n, ctx);      \
+        for (size_t i = n; i-- > 1;) {                                         \
+            name##_sort_swap_(&a[0], &a[i]);                                   \
+            name##_sort_sift_(a, 0, i, ctx);                                   \
+        }                                                                      \
+    }                                                                          \
+    static inline void name##_sort3_(type* x, type* y, type* z, void* ctx) {   \
+        if (less(y, x, ctx)) name##_sort_swap_(x, y);                          \
+        if (less(z, y, ctx)) {                                                 \
+            name##_sort_swap_(y, z);                                           \
+            if (less(y, x, ctx)) name##_sort_swap_(x, y);                      \
+        }                                                                      \
+    }                                                                          \
+    /* Pivot *b; smaller elements go left, the rest right. */                  \
+    static inline type* name##_sort_part_right_(type* b, type* e,              \
+                                                int* was_parted, void* ctx) {  \
+        type pivot = *b;                                                       \
+        type* first = b;                                                       \
+        type* last = e;                                                        \
+        while (less(++first, &pivot, ctx)) {}                                  \
+        if (first - 1 == b) {                                                  \
+            while (first < last && !less(--last, &pivot, ctx)) {}              \
+        } else {                                                               \
+            while (!less(--last, &pivot, ctx)) {}                              \
+        }                                                                      \
+        *was_parted = first >= last;                                           \
+        while (first < last) {                                                 \
+            name##_sort_swap_(first, last);                                    \
+            while (less(++first, &pivot, ctx)) {}                              \
+            while (!less(--last, &pivot, ctx)) {}                              \
+        }                                                                      \
+        type* at = first - 1;                                                  \
+        *b = *at;                                                              \
+        *at = pivot;                                                           \
+        return at;                                                             \
+    }                                                                          \
+    /* Elements equal to the pivot go left; used when the pivot equals the  \
+       one before the range, so that whole left side is one key. */           \
+    static inline type* name##_sort_part_left_(type* b, type* e, void* ctx) {  \
+        type pivot = *b;                                                       \
+        type* first = b;                                                       \
+        type* last = e;                                                        \
+        while (less(&pivot, --last, ctx)) {}                                   \
+        if (last + 1 == e) {                                                   \
+            while (first < last && !less(&pivot, ++first, ctx)) {}             \
+        } else {                                                               \
+            while (!less(&pivot, ++first, ctx)) {}                             \
+        }                                                                      \
+        while (first < last) {                                                 \
+            name##_sort_swap_(first, last);                                    \
+            while (less(&pivot, --last, ctx)) {}                               \
+            while (!less(&pivot, ++first, ctx)) {}                             \
+        }                                                                      \
+        *b = *last;                                                            \
+        *last = pivot;                                                         \
+        return last;                                                           \
+    }                                                                          \
+    static void name##_sort_loop_(type* b, type* e, int bad, int leftmost,     \
+                                  void* ctx) {                                 \
+        for (;;) {                                                             \
+            size_t n = (size_t)(e - b);                                        \
+            if (n < ECLIB_SORT_INSERTION_MAX) {                                \
+                name##_sort_ins_(b, e, ctx);                                   \
+                return;                                                        \
+            }                                                                  \
+            /* Median to *b */                                                 \
+            size_t h = n / 2;                                                  \
+            if (n > ECLIB_SORT_NINTHER_MIN) {                                  \
+                name##_sort3_(b, b + h, e - 1, ctx);                           \
+                name##_sort3_(b + 1, b + h - 1, e - 2, ctx);                   \
+                name##_sort3_(b + 2, b + h + 1, e - 3, ctx);                   \
+                name##_sort3_(b + h - 1, b + h, b + h + 1, ctx);               \
+                name##_sort_swap_(b, b + h);                                   \
+            } else {                                                           \
+                name##_sort3_(b + h, b, e - 1, ctx);                           \
+            }                                                                  \
+            if (!leftmost && !less(b - 1, b, ctx)) {                           \
+                b = name##_sort_part_left_(b, e, ctx) + 1;                     \
+                continue;                                                      \
+            }                                                                  \
+            int parted;                                                        \
+            type* p = name##_sort_part_right_(b, e, &parted, ctx);             \
+            size_t ln = (size_t)(p - b);                                       \
+            size_t rn = (size_t)(e - (p + 1));                                 \
+            if (ln < n / 8 || rn < n / 8) {                                    \
+                if (--bad == 0) {                                              \
+                    name##_sort_heap_(b, n, ctx);                              \
+                    return;                                                    \
+                }                                                              \
+                /* Break up whatever pattern caused it */                      \
+                if (ln >= ECLIB_SORT_INSERTION_MAX) {                          \
+                    name##_sort_swap_(b, b + ln / 4);                          \
+                    name##_sort_swap_(p - 1, p - ln / 4);                      \
+                    if (ln > ECLIB_SORT_NINTHER_MIN) {                         \
+                        name##_sort_swap_(b + 1, b + (ln / 4 + 1));            \
+                        name##_sort_swap_(b + 2, b + (ln / 4 + 2));            \
+                        name##_sort_swap_(p - 2, p - (ln / 4 + 1));            \
+                        name##_sort_swap_(p - 3, p - (ln / 4 + 2));            \
+                    }                                                          \
+                }                                                              \
+                if (rn >= ECLIB_SORT_INSERTION_MAX) {                          \
+                    name##_sort_swap_(p + 1, p + (1 + rn / 4));                \
+                    name##_sort_swap_(e - 1, e - rn / 4);                      \
+                    if (rn > ECLIB_SORT_NINTHER_MIN) {                         \
+                        name##_sort_swap_(p + 2, p + (2 + rn / 4));            \
+                        name##_sort_swap_(p + 3, p + (3 + rn / 4));            \
+                        name##_sort_swap_(e - 2, e - (1 + rn / 4));            \
+                        name##_sort_swap_(e - 3, e - (2 + rn / 4));            \
+                    }                                                          \
+                }                                                              \
+            } else if (parted && name##_sort_try_ins_(b, p, ctx) &&            \
+                       name##_sort_try_ins_(p + 1, e, ctx)) {                  \
+                return;                                                        \
+            }                                                                  \
+            /* Recurse into the smaller side, loop on the larger */            \
+            if (ln < rn) {                                                     \
+                name##_sort_loop_(b, p, bad, leftmost, ctx);                   \
+                b = p + 1;                                                     \
+                leftmost = 0;                                                  \
+            } else {                                                           \
+                name##_sort_loop_(p + 1, e, bad, 0, ctx);                      \
+                e = p;                                                         \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+    static inline void name##_sort_r(type* a, size_t n, void* ctx) {           \
+        if (a == NULL || n < 2) return;                                        \
+        int bad = 0;                                                           \
+        for (size_t m = n; m; m >>= 1) bad++;                                  \
+        name##_sort_loop_(a, a + n, bad, 1, ctx);                              \
+    }                                                                          \
+    static inline size_t name##_lower_bound_r(const type* a, size_t n,         \
+                                              const type* key, void* ctx) {    \
+        if (a == NULL || n == 0) return 0;                                     \
+        const type* base = a;                                                  \
+        while (n > 1) {                                                        \
+            size_t half = n / 2;                                               \
+            base = less(&base[half], key, ctx) ? &base[half] : base;           \
+            n -= half;                                                         \
+        }                                                                      \
+        return (size_t)(base - a) + (less(base, key, ctx) ? 1 : 0);            \
+    }                                                                          \
+    static inline type* name##_bsearch_r(const type* a, size_t n,              \
+                                         const type* key, void* ctx) {         \
+        size_t i = name##_lower_bound_r(a, n, key, ctx);                       \
+        if (i == n || less(key, &a[i], ctx)) return NULL;                      \
+        return (type*)&a[i];                                                   \
+    }
+
+#endif // ECLIB_SORT_H
@@ -10,12 +10,15 @@
  */
 #ifndef ECLIB_UTILS_H
 #define ECLIB_UTILS_H
+#include "error.h"
 #include <stddef.h>
 #include <stdint.h>
+#include <stdarg.h>
 // --------------------------
 // String 
 // --------------------------
 size_t eclib_strlen(const char* str);
+size_t eclib_strnlen(const char* str, size_t max_len);
 char* eclib_strncpy(char* dest, const char* src, size_t max_len);
 int eclib_strcmp(const char* str1, const char* str2);
 int eclib_strncmp(const char* str1, const char* str2, size_t n);
@@ -23,13 +26,246 @@ const char* eclib_strstr(const char* str, const char* substr);
 char* eclib_strchr(const char* s, int c);
 char* eclib_strrchr(const char* s, int c);
 char* eclib_strdup(const char* s);
+/*
+ * Per-thread position; prefer eclib_strtok_r.
+ */
 char* eclib_strtok(char* str, const char* delim);
-int eclib_snprintf(char* buf, size_t size, const char* fmt, ...);
+char* eclib_strtok_r(char* str, const char* delim, char** save);
+// --------------------------
+// Tokens
+// --------------------------
+/*
+ * A set of byte values, for delimiters. Bit (c >> 4) & 7 of
+ * map[(c >> 7) * 16 + (c & 15)]; that layout lets a vector byte shuffle
+ * classify a whole block of input at once.
+ */
+typedef struct {
+    uint8_t map[32];
+} eclib_charset_t;
+/*
+ * Set holding chars[0..n). n is explicit so '\0' can be a member.
+ */
+void eclib_charset_init(eclib_charset_t* set, const char* chars, size_t n);
+void eclib_charset_add(eclib_charset_t* set, unsigned char c);
+int eclib_charset_has(const eclib_charset_t* set, unsigned char c);
+size_t eclib_strspn(const char* s, const char* accept);
+size_t eclib_strcspn(const char* s, const char* reject);
+/*
+ * eclib_strtok_r with a prebuilt delimiter set, for tokenizing many
+ * strings the same way.
+ */
+char* eclib_strtok_set(char* str, const eclib_charset_t* delims, char** save);
+/*
+ * Pointer and length into someone else's memory; not NUL terminated.
+ */
+typedef struct {
+    const char* ptr;
+    size_t len;
+} eclib_strview_t;
+/*
+ * Splits data[0..len) into views without writing to it, so it works on
+ * const buffers, on NUL-separated blobs (delimiter '\0') and on "KEY=VALUE"
+ * messages. delims must outlive the tokenizer.
+ */
+typedef struct {
+    const char* pos;
+    const char* end;
+    const eclib_charset_t* delims;
+} eclib_tokenizer_t;
+void eclib_tokenizer_init(eclib_tokenizer_t* tok, const void* data, size_t len,
+                          const eclib_charset_t* delims);
+/*
+ * Next token, skipping runs of delimiters like strtok.
+ * Return: 1 with *out set, 0 at the end
+ */
+int eclib_tokenizer_next(eclib_tokenizer_t* tok, eclib_strview_t* out);
+/*
+ * Next field: every delimiter ends one, so empty fields are returned.
+ * A delimiter as the last byte ends the last field rather than opening
+ * an empty one ("a\0b\0" is two fields).
+ * Return: 1 with *out set, 0 at the end
+ */
+int eclib_tokenizer_field(eclib_tokenizer_t* tok, eclib_strview_t* out);
+/*
+ * Split sv at the first sep ("KEY=VALUE"). Without one, *head is sv and
+ * *tail is empty. Either output may be NULL.
+ * Return: 1 if sep was found, 0 if not
+ */
+int eclib_strview_split(eclib_strview_t sv, char sep,
+                        eclib_strview_t* head, eclib_strview_t* tail);
+// --------------------------
+// Numbers
+// --------------------------
+/*
+ * C-style conversions: leading white space, a sign, and for integers an
+ * optional 0x (base 0 or 16) or 0 (base 0) prefix. *end, if given, gets
+ * the first unused character, or s if there was no number.
+ * eclib_strtod takes decimal forms, inf/infinity and nan; not hex floats.
+ * Results are correctly rounded.
+ * Return: the value; out of range values are clamped (0 or infinity for
+ *         doubles) and set ECLIB_ECLIB_OUT_OF_RANGE as the last error
+ */
+long eclib_strtol(const char* s, char** end, int base);
+unsigned long long eclib_strtoull(const char* s, char** end, int base);
+double eclib_strtod(const char* s, char** end);
+/*
+ * The same for s[0..len), which need not be NUL terminated -- e.g. an
+ * eclib_strview_t. No leading white space is skipped. *out is only
+ * written when a number was found; a negative number for the unsigned
+ * variant is out of range.
+ * Return: characters used, 0 if s does not start with a number
+ */
+size_t eclib_parse_i64(const char* s, size_t len, int base, int64_t* out);
+size_t eclib_parse_u64(const char* s, size_t len, int base, uint64_t* out);
+size_t eclib_parse_double(const char* s, size_t len, double* out);
+// --------------------------
+// Format
+// --------------------------
+/*
+ * Receives formatted output piece by piece. data is not NUL terminated
+ * and only valid for the duration of the call.
+ */
+typedef void (*eclib_sink_fn)(void* ctx, const char* data, size_t len);
+/*
+ * printf-style formatting.
+ * Supports the flags "-+ #0", width and precision (also as "*"), the
+ * length modifiers hh h l ll z j t L and the conversions d i u o x X c s
+ * p f F e E g G %. Doubles with a precision are exact and round half to
+ * even; without one they print the shortest digits that read back as the
+ * same double (%f: 0.1, 2.5, 1e21 as 1000000000000000000000; %e: 1e-01)
+ * instead of six. %g then switches to the exponent form as it would by
+ * default, below 1e-4 or from 1e6 on.
+ * Other conversions are copied through without taking an argument.
+ * Return: characters produced -- for snprintf, what would have been
+ *         written had size been big enough -- or -1 on bad arguments
+ */
+int eclib_snprintf(char* buf, size_t size, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+int eclib_vsnprintf(char* buf, size_t size, const char* fmt, va_list ap);
+/*
+ * Same formatting, streamed to sink in chunks instead of into a buffer.
+ */
+int eclib_format(eclib_sink_fn sink, void* ctx, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+int eclib_vformat(eclib_sink_fn sink, void* ctx, const char* fmt, va_list ap);
 // --------------------------
 // Mentory
 // --------------------------
 void* eclib_memcpy(void* dest, const void* src, size_t len);
-void* eclib_memmove(void* dest, const void* src, size_t len);void* eclib_memset(void* ptr, int value, size_t len);
+void* eclib_memmove(void* dest, const void* src, size_t len);
+void* eclib_memset(void* ptr, int value, size_t len);
+void* eclib_memchr(const void* ptr, int value, size_t len);
+void* eclib_memrchr(const void* ptr, int value, size_t len);
+int eclib_memcmp(const void* ptr1, const void* ptr2, size_t len);
+/*
+ * Find needle in a binary buffer. An empty needle matches at hay.
+ * Return: first occurrence, or NULL
+ */
+void* eclib_memmem(const void* hay, size_t hay_len,
+                   const void* needle, size_t needle_len);
+// --------------------------
+// Hash
+// --------------------------
+/*
+ * Fast non-cryptographic 64-bit hashes (wyhash). Equal input and seed
+ * give equal output in every process; pick a random seed where callers
+ * can choose keys. eclib_hash_str hashes the bytes without the NUL, so it
+ * agrees with eclib_hash_bytes on the same characters.
+ */
+uint64_t eclib_hash_bytes(const void* data, size_t len, uint64_t seed);
+uint64_t eclib_hash_str(const char* str, uint64_t seed);
+uint64_t eclib_hash_u64(uint64_t value, uint64_t seed);
+// --------------------------
+// Checksum
+// --------------------------
+/*
+ * CRC-32C (Castagnoli), using the CPU's CRC instructions when it has them.
+ * Start with crc = 0 and pass the previous result to continue, so
+ * eclib_crc32c(eclib_crc32c(0, a, na), b, nb) is the CRC of a then b.
+ * Return: The updated CRC
+ */
+uint32_t eclib_crc32c(uint32_t crc, const void* data, size_t len);
+/*
+ * CRC of a then b from crc1 = CRC of a and crc2 = CRC of b, where b is
+ * len2 bytes long; lets pieces be checksummed separately.
+ */
+uint32_t eclib_crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2);
+// --------------------------
+// Unicode
+// --------------------------
+/*
+ * Check that s[0..len) is UTF-8 as RFC 3629 has it: shortest forms only,
+ * no surrogates, nothing above U+10FFFF.
+ * Return: len if it is, otherwise the offset of the first bad sequence (a
+ *         sequence cut off by the end of the buffer counts as bad)
+ */
+size_t eclib_utf8_check(const char* s, size_t len);
+/*
+ * Code points in valid UTF-8 (every byte but 10xxxxxx starts one)
+ */
+size_t eclib_utf8_count(const char* s, size_t len);
+/*
+ * Transcode between UTF-8 and UTF-16 (native byte order, surrogate pairs)
+ * or UTF-32. Output is counted in units of the target and never
+ * terminated. cap = len always suffices towards UTF-16 or UTF-32; towards
+ * UTF-8 it takes 3 bytes per UTF-16 unit and 4 per UTF-32 unit.
+ * Parameters:
+ *   s, len: Input, len in its own units
+ *   out, cap: Output buffer
+ *   out_len: Receives the units written, up to the failing input on error
+ * Return: ECLIB_OK, ECLIB_ECLIB_INVALID_ENCODING or
+ *         ECLIB_ECLIB_BUFFER_TOO_SMALL
+ */
+eclib_err_t eclib_utf8_to_utf16(const char* s, size_t len, uint16_t* out,
+                                size_t cap, size_t* out_len);
+eclib_err_t eclib_utf8_to_utf32(const char* s, size_t len, uint32_t* out,
+                                size_t cap, size_t* out_len);
+eclib_err_t eclib_utf16_to_utf8(const uint16_t* s, size_t len, char* out,
+                                size_t cap, size_t* out_len);
+eclib_err_t eclib_utf32_to_utf8(const uint32_t* s, size_t len, char* out,
+                                size_t cap, size_t* out_len);
+/*
+ * Longest prefix of s[0..len) of at most max bytes that does not end
+ * inside a multi-byte sequence
+ */
+size_t eclib_utf8_truncate(const char* s, size_t len, size_t max);
+/*
+ * eclib_strncpy that, when src does not fit, drops a character cut in
+ * half along with the rest. dest always gets a NUL.
+ */
+char* eclib_utf8_strncpy(char* dest, const char* src, size_t max_len);
+// --------------------------
+// Search
+// --------------------------
+/*
+ * Needle prepared once for repeated searches (Two-Way factorisation plus
+ * a last-byte shift table). The needle bytes are not copied and must
+ * outlive it. About 2 KiB, so keep long-lived ones off small stacks.
+ */
+typedef struct {
+    const uint8_t* needle;
+    size_t len;
+    size_t ms;              // critical position
+    size_t period;
+    size_t mem0;            // bytes known to match after a period shift
+    size_t skip[256];       // window shift by its last byte
+} eclib_needle_t;
+/*
+ * Prepare nd for needle[0..len). len may be 0 (matches everywhere).
+ */
+void eclib_needle_init(eclib_needle_t* nd, const void* needle, size_t len);
+/*
+ * Search hay[0..hay_len) / the string str for a prepared needle.
+ * Return: first occurrence, or NULL
+ */
+const void* eclib_needle_find(const eclib_needle_t* nd, const void* hay,
+                              size_t hay_len);
+const char* eclib_needle_find_str(const eclib_needle_t* nd, const char* str);
+/*
+ * Select the fastest memory and string routines for this CPU. _start and a
+ * constructor both call it; until then portable versions are used.
+ */
+void eclib_utils_init(void);
 // --------------------------
 // Char
 // --------------------------
@@ -37,4 +273,93 @@ int eclib_isdigit(int c);
 int eclib_isalpha(int c);
 int eclib_tolower(int c);
 int eclib_toupper(int c);
+// --------------------------
+// Inline fast paths
+// --------------------------
+// Copies and fills whose size is a compile-time constant (sizeof a
+// request, a small array) become a few plain loads and stores, and the
+// length of a string literal is folded to a constant. Everything else
+// goes to the out-of-line routines and their SIMD kernels. Write the name
+// in parentheses, (eclib_memcpy)(...), to always call the real function.
+#define ECLIB_INLINE_MAX    64
+
+static inline __attribute__((always_inline))
+void eclib_copy_const_(void* dest, const void* src, size_t len) {
+    typedef uint64_t u64u __attribute__((may_alias, aligned(1)));
+    typedef uint32_t u32u __attribute__((may_alias, aligned(1)));
+    typedef uint16_t u16u __attribute__((may_alias, aligned(1)));
+    unsigned char* d = dest;
+    const unsigned char* s = src;
+    if (len >= 8) {
+        size_t i = 0;
+#pragma GCC unroll 8
+        for (; i + 8 <= len; i += 8) *(u64u*)(d + i) = *(const u64u*)(s + i);
+        // Odd tail: one more word, overlapping what is already copied
+        if (i < len) *(u64u*)(d + len - 8) = *(const u64u*)(s + len - 8);
+    } else if (len >= 4) {
+        uint32_t a = *(const u32u*)s, b = *(const u32u*)(s + len - 4);
+        *(u32u*)d = a;
+        *(u32u*)(d + len - 4) = b;
+    } else if (len >= 2) {
+        uint16_t a = *(const u16u*)s, b = *(const u16u*)(s + len - 2);
+        *(u16u*)d = a;
+        *(u16u*)(d + len - 2) = b;
+    } else if (len) {
+        *d = *s;
+    }
+}
+
+static inline __attribute__((always_inline))
+void eclib_fill_const_(void* ptr, int value, size_t len) {
+    typedef uint64_t u64u __attribute__((may_alias, aligned(1)));
+    typedef uint32_t u32u __attribute__((may_alias, aligned(1)));
+    typedef uint16_t u16u __attribute__((may_alias, aligned(1)));
+    unsigned char* d = ptr;
+    uint64_t v = 0x0101010101010101ull * (unsigned char)value;
+    if (len >= 8) {
+        size_t i = 0;
+#pragma GCC unroll 8
+        for (; i + 8 <= len; i += 8) *(u64u*)(d + i) = v;
+        if (i < len) *(u64u*)(d + len - 8) = v;
+    } else if (len >= 4) {
+        *(u32u*)d = (uint32_t)v;
+        *(u32u*)(d + len - 4) = (uint32_t)v;
+    } else if (len >= 2) {
+        *(u16u*)d = (uint16_t)v;
+        *(u16u*)(d + len - 2) = (uint16_t)v;
+    } else if (len) {
+        *d = (unsigned char)v;
+    }
+}
+
+static inline __attribute__((always_inline))
+void* eclib_memcpy_inline(void* dest, const void* src, size_t len) {
+    if (__builtin_constant_p(len) && len <= ECLIB_INLINE_MAX) {
+        if (dest != NULL && src != NULL) eclib_copy_const_(dest, src, len);
+        return dest;
+    }
+    return (eclib_memcpy)(dest, src, len);
+}
+
+static inline __attribute__((always_inline))
+void* eclib_memset_inline(void* ptr, int value, size_t len) {
+    if (__builtin_constant_p(len) && len <= ECLIB_INLINE_MAX) {
+        if (ptr != NULL) eclib_fill_const_(ptr, value, len);
+        return ptr;
+    }
+    return (eclib_memset)(ptr, value, len);
+}
+
+static inline __attribute__((always_inline))
+size_t eclib_strlen_inline(const char* str) {
+    // Only taken when the compiler can fold it, so never a libc call
+    if (__builtin_constant_p(__builtin_strlen(str))) {
+        return __builtin_strlen(str);
+    }
+    return (eclib_strlen)(str);
+}
+
+#define eclib_memcpy(dest, src, len)    eclib_memcpy_inline(dest, src, len)
+#define eclib_memset(ptr, value, len)   eclib_memset_inline(ptr, value, len)
+#define eclib_strlen(str)               eclib_strlen_inline(str)
 #endif
\ No newline at end of file
@@ -0,0 +1,719 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/compress.h"
+#include "eclib/men.h"
+#include "eclib/error.h"
+#include "eclib/utils.h"
+
+// Block format (LZ4): a sequence is
+//   token           high nibble literal count, low nibble match length - 4;
+//                   15 means more follows as bytes of 255 ended by one < 255
+//   literals
+//   offset          2 bytes little-endian, 1..65535 back from the output
+//   match length    extra bytes as above
+// The last sequence stops after its literals. Matches end at least five
+// bytes before the end of the block and none starts in the last twelve,
+// which is what lets decoders copy in whole words.
+#define MINMATCH        4
+#define LASTLITERALS    5
+#define MFLIMIT         12
+#define MAX_DISTANCE    65535
+#define DICT_MAX        (64 * 1024)
+#define RUN_MASK        15
+#define ML_MASK         15
+#define HASH_LOG        ECLIB_ZDICT_HASH_LOG
+// After 64 positions without a match the search starts skipping ahead,
+// one more byte per 64 misses, so incompressible data goes by quickly
+#define SKIP_TRIGGER    6
+// Positions are 32-bit indices over dictionary + input
+#define MAX_INPUT       0x7E000000u
+
+typedef uint32_t z_u32 __attribute__((aligned(1), may_alias));
+typedef uint64_t z_u64 __attribute__((aligned(1), may_alias));
+
+static inline uint32_t read32(const uint8_t* p) { return *(const z_u32*)p; }
+static inline uint64_t read64(const uint8_t* p) { return *(const z_u64*)p; }
+
+static inline void copy8(uint8_t* d, const uint8_t* s) {
+    *(z_u64*)d = *(const z_u64*)s;
+}
+
+static inline void copy16(uint8_t* d, const uint8_t* s) {
+    uint64_t a = *(const z_u64*)s, b = *(const z_u64*)(s + 8);
+    *(z_u64*)d = a;
+    *(z_u64*)(d + 8) = b;
+}
+
+static inline uint32_t read32_le(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+           (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline void write32_le(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t hash4(uint32_t seq) {
+    return (seq * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// Number of equal bytes at ip and ref, ip not going past limit
+static inline size_t match_len(const uint8_t* ip, const uint8_t* ref,
+                               const uint8_t* limit) {
+    const uint8_t* start = ip;
+
+    while (ip + 8 <= limit) {
+        uint64_t diff = read64(ip) ^ read64(ref);
+        if (diff) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            return (size_t)(ip - start) + (__builtin_clzll(diff) >> 3);
+#else
+            return (size_t)(ip - start) + (__builtin_ctzll(diff) >> 3);
+#endif
+        }
+        ip += 8;
+        ref += 8;
+    }
+    while (ip < limit && *ip == *ref) {
+        ip++;
+        ref++;
+    }
+    return (size_t)(ip - start);
+}
+
+static inline uint8_t* put_len(uint8_t* op, size_t n) {
+    while (n >= 255) {
+        *op++ = 255;
+        n -= 255;
+    }
+    *op++ = (uint8_t)n;
+    return op;
+}
+
+// Bytes put_len writes after a token field of mask for a length of n
+static inline size_t len_bytes(size_t n, size_t mask) {
+    return n >= mask ? (n - mask) / 255 + 1 : 0;
+}
+
+// --------------------------
+// Compress
+// --------------------------
+// Greedy parse with one candidate per hash bucket. table maps the hash of
+// four bytes to the index where they were last seen; indices below dlen
+// are in the dictionary, the rest in src. The dictionary is a constant
+// NULL in one instantiation, so the plain path carries none of it.
+// Return: compressed size, 0 if it does not fit in cap
+static inline __attribute__((always_inline))
+size_t lz_compress(const uint8_t* src, size_t len, uint8_t* dst, size_t cap,
+                   const eclib_zdict_t* dict, uint32_t* table) {
+    const uint8_t* dbase = dict ? dict->data : NULL;
+    uint32_t dlen = dict ? (uint32_t)dict->len : 0;
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* iend = src + len;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + cap;
+
+    if (len >= MFLIMIT + 1) {
+        const uint8_t* mflimit = iend - MFLIMIT;
+        const uint8_t* matchlimit = iend - LASTLITERALS;
+
+        for (;;) {
+            const uint8_t* ref;
+            uint32_t ref_idx, cur;
+            unsigned search = 1u << SKIP_TRIGGER;
+
+            // Find four equal bytes within reach
+            for (;;) {
+                if (ip > mflimit) goto last;
+                uint32_t seq = read32(ip);
+                uint32_t h = hash4(seq);
+                cur = dlen + (uint32_t)(ip - src);
+                ref_idx = table[h];
+                table[h] = cur;
+                if (cur - ref_idx <= MAX_DISTANCE && ref_idx < cur) {
+                    ref = (dict && ref_idx < dlen) ? dbase + ref_idx
+                                                   : src + (ref_idx - dlen);
+                    if (read32(ref) == seq) break;
+                }
+                ip += search++ >> SKIP_TRIGGER;
+            }
+
+            int in_dict = dict && ref_idx < dlen;
+            const uint8_t* low = in_dict ? dbase : src;
+            uint32_t offset = cur - ref_idx;
+
+            // Extend backwards over literals that also match
+            while (ip > anchor && ref > low && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+
+            size_t lit = (size_t)(ip - anchor);
+            if ((size_t)(oend - op) < 1 + len_bytes(lit, RUN_MASK) + lit + 2) {
+                return 0;
+            }
+            uint8_t* token = op++;
+            if (lit >= RUN_MASK) {
+                *token = RUN_MASK << 4;
+                op = put_len(op, lit - RUN_MASK);
+            } else {
+                *token = (uint8_t)(lit << 4);
+            }
+            // anchor + 8 <= ip + 8 stays inside the input here
+            if (lit <= 8 && oend - op >= 8) {
+                copy8(op, anchor);
+            } else {
+                eclib_memcpy(op, anchor, lit);
+            }
+            op += lit;
+            op[0] = (uint8_t)offset;
+            op[1] = (uint8_t)(offset >> 8);
+            op += 2;
+
+            size_t ml;
+            if (in_dict) {
+                // A match in the dictionary may run on into src, which
+                // follows it in index order
+                const uint8_t* limit = ip + (dbase + dlen - ref);
+                if (limit > matchlimit) limit = matchlimit;
+                ml = match_len(ip + MINMATCH, ref + MINMATCH, limit);
+                if (ip + MINMATCH + ml == limit && limit < matchlimit) {
+                    ml += match_len(limit, src, matchlimit);
+                }
+            } else {
+                ml = match_len(ip + MINMATCH, ref + MINMATCH, matchlimit);
+            }
+
+            if ((size_t)(oend - op) < len_bytes(ml, ML_MASK)) return 0;
+            if (ml >= ML_MASK) {
+                *token |= ML_MASK;
+                op = put_len(op, ml - ML_MASK);
+            } else {
+                *token |= (uint8_t)ml;
+            }
+            ip += MINMATCH + ml;
+            anchor = ip;
+            if (ip > mflimit) break;
+            // Cheap extra entry: the position just before the next search
+            table[hash4(read32(ip - 2))] = dlen + (uint32_t)(ip - 2 - src);
+        }
+    }
+
+last:;
+    size_t lit = (size_t)(iend - anchor);
+    if ((size_t)(oend - op) < 1 + len_bytes(lit, RUN_MASK) + lit) return 0;
+    if (lit >= RUN_MASK) {
+        *op++ = RUN_MASK << 4;
+        op = put_len(op, lit - RUN_MASK);
+    } else {
+        *op++ = (uint8_t)(lit << 4);
+    }
+    eclib_memcpy(op, anchor, lit);
+    op += lit;
+    return (size_t)(op - dst);
+}
+
+static size_t block_compress(const uint8_t* src, size_t len,
+                             uint8_t* dst, size_t cap,
+                             const eclib_zdict_t* dict) {
+    uint32_t table[1 << HASH_LOG];
+
+    if (dict && dict->len) {
+        eclib_memcpy(table, dict->table, sizeof(table));
+        return lz_compress(src, len, dst, cap, dict, table);
+    }
+    eclib_memset(table, 0, sizeof(table));
+    return lz_compress(src, len, dst, cap, NULL, table);
+}
+
+// --------------------------
+// Decompress
+// --------------------------
+static inline int get_len(const uint8_t** ip, const uint8_t* iend,
+                          size_t* len) {
+    const uint8_t* p = *ip;
+    size_t n = *len;
+    unsigned s;
+
+    do {
+        if (p >= iend) return 0;
+        s = *p++;
+        n += s;
+    } while (s == 255);
+    *ip = p;
+    *len = n;
+    return 1;
+}
+
+static eclib_err_t lz_decompress(const uint8_t* src, size_t len,
+                                 uint8_t* dst, size_t cap,
+                                 const eclib_zdict_t* dict, size_t* out_len) {
+    const uint8_t* ip = src;
+    const uint8_t* iend = src + len;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + cap;
+    size_t dlen = dict ? dict->len : 0;
+
+    if (len == 0) return ECLIB_ECLIB_CORRUPT_DATA;
+    for (;;) {
+        // The last sequence is literals only, so input that runs out
+        // right after a match (10 61 01 00) is damaged
+        if (ip >= iend) return ECLIB_ECLIB_CORRUPT_DATA;
+        unsigned token = *ip++;
+        size_t lit = token >> 4;
+        if (lit == RUN_MASK && !get_len(&ip, iend, &lit)) {
+            return ECLIB_ECLIB_CORRUPT_DATA;
+        }
+        if (lit > (size_t)(iend - ip)) return ECLIB_ECLIB_CORRUPT_DATA;
+        if (lit > (size_t)(oend - op)) return ECLIB_ECLIB_BUFFER_TOO_SMALL;
+        if ((size_t)(iend - ip) >= lit + 16 && (size_t)(oend - op) >= lit + 16) {
+            // Whole 16-byte pieces; the overrun is written over next
+            uint8_t* d = op;
+            const uint8_t* s = ip;
+            do {
+                copy16(d, s);
+                d += 16;
+                s += 16;
+            } while (d < op + lit);
+        } else {
+            eclib_memcpy(op, ip, lit);
+        }
+        op += lit;
+        ip += lit;
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return ECLIB_ECLIB_CORRUPT_DATA;
+        size_t offset = (size_t)ip[0] | (size_t)ip[1] << 8;
+        ip += 2;
+        size_t ml = token & ML_MASK;
+        if (ml == ML_MASK && !get_len(&ip, iend, &ml)) {
+            return ECLIB_ECLIB_CORRUPT_DATA;
+        }
+        ml += MINMATCH;
+        if (ml > (size_t)(oend - op)) return ECLIB_ECLIB_BUFFER_TOO_SMALL;
+
+        size_t done = (size_t)(op - dst);
+        if (offset == 0) return ECLIB_ECLIB_CORRUPT_DATA;
+        if (offset > done) {
+            // Starts in the dictionary, may run on into the output
+            size_t back = offset - done;
+            if (back > dlen) return ECLIB_ECLIB_CORRUPT_DATA;
+            size_t n = ml < back ? ml : back;
+            eclib_memcpy(op, dict->data + dlen - back, n);
+            op += n;
+            ml -= n;
+            for (size_t i = 0; i < ml; i++) op[i] = dst[i];
+            op += ml;
+            continue;
+        }
+
+        const uint8_t* m = op - offset;
+        if (offset >= 16 && (size_t)(oend - op) >= ml + 16) {
+            // Up to 15 bytes past the match, overwritten by what follows
+            uint8_t* end = op + ml;
+            do {
+                copy16(op, m);
+                op += 16;
+                m += 16;
+            } while (op < end);
+            op = end;
+        } else if (offset >= 8 && (size_t)(oend - op) >= ml + 8) {
+            uint8_t* end = op + ml;
+            do {
+                copy8(op, m);
+                op += 8;
+                m += 8;
+            } while (op < end);
+            op = end;
+        } else {
+            // Short offsets repeat a pattern: each copy may take all that
+            // lies between m and op, which doubles every round
+            while (ml) {
+                size_t n = (size_t)(op - m);
+                if (n > ml) n = ml;
+                eclib_memcpy(op, m, n);
+                op += n;
+                ml -= n;
+            }
+        }
+    }
+    *out_len = (size_t)(op - dst);
+    return ECLIB_OK;
+}
+
+// --------------------------
+// Blocks
+// --------------------------
+static eclib_err_t compress_common(const void* src, size_t len, void* dst,
+                                   size_t cap, size_t* out_len,
+                                   const eclib_zdict_t* dict) {
+    if ((src == NULL && len) || (dst == NULL && cap) || out_len == NULL ||
+        len > MAX_INPUT) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return ECLIB_ECLIB_INVALID_PARAMETER;
+    }
+    size_t n = block_compress(src, len, dst, cap, dict);
+    if (n == 0) {
+        eclib_set_last_err(ECLIB_ECLIB_BUFFER_TOO_SMALL);
+        return ECLIB_ECLIB_BUFFER_TOO_SMALL;
+    }
+    *out_len = n;
+    return ECLIB_OK;
+}
+
+static eclib_err_t decompress_common(const void* src, size_t len, void* dst,
+                                     size_t cap, size_t* out_len,
+                                     const eclib_zdict_t* dict) {
+    if ((src == NULL && len) || (dst == NULL && cap) || out_len == NULL) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return ECLIB_ECLIB_INVALID_PARAMETER;
+    }
+    eclib_err_t err = lz_decompress(src, len, dst, cap, dict, out_len);
+    if (err != ECLIB_OK) eclib_set_last_err(err);
+    return err;
+}
+
+eclib_err_t eclib_compress(const void* src, size_t len,
+                           void* dst, size_t cap, size_t* out_len) {
+    return compress_common(src, len, dst, cap, out_len, NULL);
+}
+
+eclib_err_t eclib_decompress(const void* src, size_t len,
+                             void* dst, size_t cap, size_t* out_len) {
+    return decompress_common(src, len, dst, cap, out_len, NULL);
+}
+
+eclib_err_t eclib_compress_dict(const void* src, size_t len,
+                                void* dst, size_t cap, size_t* out_len,
+                                const eclib_zdict_t* dict) {
+    return compress_common(src, len, dst, cap, out_len, dict);
+}
+
+eclib_err_t eclib_decompress_dict(const void* src, size_t len,
+                                  void* dst, size_t cap, size_t* out_len,
+                                  const eclib_zdict_t* dict) {
+    return decompress_common(src, len, dst, cap, out_len, dict);
+}
+
+void eclib_zdict_init(eclib_zdict_t* dict, const void* data, size_t len) {
+    const uint8_t* p = data;
+
+    if (dict == NULL) return;
+    if (len > DICT_MAX) {
+        p += len - DICT_MAX;
+        len = DICT_MAX;
+    }
+    // Empty table entries point at index 0, which must be readable
+    if (p == NULL || len < MINMATCH) len = 0;
+    dict->data = p;
+    dict->len = len;
+    dict->id = eclib_crc32c(0, p, len);
+    eclib_memset(dict->table, 0, sizeof(dict->table));
+    for (size_t i = 0; i + MINMATCH <= len; i++) {
+        dict->table[hash4(read32(p + i))] = (uint32_t)i;
+    }
+}
+
+// --------------------------
+// Frames
+// --------------------------
+// Frame layout, all numbers little-endian:
+//   magic "ECZ1", flags (1), log2 of the block size (1), reserved (2)
+//   dictionary id (4)                      if FRAME_DICT
+//   blocks: size (4) with RAW_BLOCK set when stored as is, the data, and
+//           CRC-32C of the stored bytes (4) with ECLIB_Z_BLOCK_CHECKSUM
+//   0 (4)                                  end mark
+//   CRC-32C of the content (4)             with ECLIB_Z_CONTENT_CHECKSUM
+#define FRAME_MAGIC         0x315A4345u     // "ECZ1"
+#define FRAME_DICT          0x80
+#define FRAME_FLAGS         (ECLIB_Z_BLOCK_CHECKSUM | ECLIB_Z_CONTENT_CHECKSUM)
+#define FRAME_BLOCK_LOG     16
+#define RAW_BLOCK           0x80000000u
+#define BLOCK_BOUND         (ECLIB_ZBLOCK_MAX + ECLIB_ZBLOCK_MAX / 255 + 16)
+// Compressed block with its size and checksum around it
+#define BLOCK_BUF           (4 + BLOCK_BOUND + 4)
+
+static void writer_emit(eclib_zwriter_t* w, const uint8_t* data, size_t len) {
+    uint8_t* out = w->out;
+    int sum = (w->flags & ECLIB_Z_BLOCK_CHECKSUM) != 0;
+
+    if (w->flags & ECLIB_Z_CONTENT_CHECKSUM) {
+        w->content_crc = eclib_crc32c(w->content_crc, data, len);
+    }
+    // Only worth it if it shrinks
+    size_t n = block_compress(data, len, out + 4, len - 1, w->dict);
+    if (n) {
+        write32_le(out, (uint32_t)n);
+        if (sum) write32_le(out + 4 + n, eclib_crc32c(0, out + 4, n));
+        w->sink(w->ctx, (const char*)out, 4 + n + (sum ? 4 : 0));
+        return;
+    }
+    write32_le(out, RAW_BLOCK | (uint32_t)len);
+    w->sink(w->ctx, (const char*)out, 4);
+    w->sink(w->ctx, (const char*)data, len);
+    if (sum) {
+        write32_le(out, eclib_crc32c(0, data, len));
+        w->sink(w->ctx, (const char*)out, 4);
+    }
+}
+
+eclib_err_t eclib_zwriter_init(eclib_zwriter_t* w, eclib_sink_fn sink,
+                               void* ctx, uint32_t flags,
+                               const eclib_zdict_t* dict) {
+    if (w == NULL) return ECLIB_ECLIB_INVALID_PARAMETER;
+    w->in = NULL;
+    if (sink == NULL || (flags & ~FRAME_FLAGS)) {
+        w->err = ECLIB_ECLIB_INVALID_PARAMETER;
+        eclib_set_last_err(w->err);
+        return w->err;
+    }
+    w->sink = sink;
+    w->ctx = ctx;
+    w->dict = (dict && dict->len) ? dict : NULL;
+    w->flags = flags;
+    w->content_crc = 0;
+    w->in_len = 0;
+    w->err = ECLIB_OK;
+    w->in = eclib_malloc(ECLIB_ZBLOCK_MAX + BLOCK_BUF);
+    if (w->in == NULL) {
+        w->err = ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY;
+        eclib_set_last_err(w->err);
+        return w->err;
+    }
+    w->out = w->in + ECLIB_ZBLOCK_MAX;
+
+    uint8_t header[12];
+    size_t n = 8;
+    write32_le(header, FRAME_MAGIC);
+    header[4] = (uint8_t)(flags | (w->dict ? FRAME_DICT : 0));
+    header[5] = FRAME_BLOCK_LOG;
+    header[6] = header[7] = 0;
+    if (w->dict) {
+        write32_le(header + 8, w->dict->id);
+        n = 12;
+    }
+    sink(ctx, (const char*)header, n);
+    return ECLIB_OK;
+}
+
+eclib_err_t eclib_zwriter_write(eclib_zwriter_t* w, const void* data,
+                                size_t len) {
+    const uint8_t* p = data;
+
+    if (w == NULL) return ECLIB_ECLIB_INVALID_PARAMETER;
+    if (w->err != ECLIB_OK) return w->err;
+    if (p == NULL && len) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return ECLIB_ECLIB_INVALID_PARAMETER;
+    }
+    while (len) {
+        // Whole blocks straight from the caller's buffer
+        if (w->in_len == 0 && len >= ECLIB_ZBLOCK_MAX) {
+            writer_emit(w, p, ECLIB_ZBLOCK_MAX);
+            p += ECLIB_ZBLOCK_MAX;
+            len -= ECLIB_ZBLOCK_MAX;
+            continue;
+        }
+        size_t n = ECLIB_ZBLOCK_MAX - w->in_len;
+        if (n > len) n = len;
+        eclib_memcpy(w->in + w->in_len, p, n);
+        w->in_len += n;
+        p += n;
+        len -= n;
+        if (w->in_len == ECLIB_ZBLOCK_MAX) {
+            writer_emit(w, w->in, ECLIB_ZBLOCK_MAX);
+            w->in_len = 0;
+        }
+    }
+    return ECLIB_OK;
+}
+
+eclib_err_t eclib_zwriter_finish(eclib_zwriter_t* w) {
+    if (w == NULL) return ECLIB_ECLIB_INVALID_PARAMETER;
+    if (w->err == ECLIB_OK) {
+        uint8_t tail[8];
+        size_t n = 4;
+        if (w->in_len) writer_emit(w, w->in, w->in_len);
+        write32_le(tail, 0);
+        if (w->flags & ECLIB_Z_CONTENT_CHECKSUM) {
+            write32_le(tail + 4, w->content_crc);
+            n = 8;
+        }
+        w->sink(w->ctx, (const char*)tail, n);
+    }
+    eclib_free(w->in);
+    w->in = w->out = NULL;
+    w->in_len = 0;
+    return w->err;
+}
+
+// Reader states; need says how many bytes each one consumes
+enum {
+    RS_HEADER,
+    RS_DICT_ID,
+    RS_BLOCK,           // block size or end mark
+    RS_DATA,            // block data and its checksum
+    RS_CONTENT_CRC,
+    RS_DONE,
+};
+
+void eclib_zreader_init(eclib_zreader_t* r, const eclib_zdict_t* dict) {
+    if (r == NULL) return;
+    r->dict = dict;
+    r->flags = 0;
+    r->content_crc = 0;
+    r->state = RS_HEADER;
+    r->block = 0;
+    r->need = 8;
+    r->have = 0;
+    r->buf = r->out = NULL;
+    r->err = ECLIB_OK;
+}
+
+static eclib_err_t reader_step(eclib_zreader_t* r, const uint8_t* p,
+                               eclib_sink_fn sink, void* ctx) {
+    switch (r->state) {
+    case RS_HEADER: {
+        uint32_t flags = p[4];
+        if (read32_le(p) != FRAME_MAGIC ||
+            (flags & ~(FRAME_FLAGS | FRAME_DICT)) ||
+            p[5] != FRAME_BLOCK_LOG || p[6] || p[7]) {
+            return ECLIB_ECLIB_CORRUPT_DATA;
+        }
+        r->flags = flags;
+        if (flags & FRAME_DICT) {
+            if (r->dict == NULL) return ECLIB_ECLIB_CORRUPT_DATA;
+            r->state = RS_DICT_ID;
+        } else {
+            r->dict = NULL;
+            r->state = RS_BLOCK;
+        }
+        r->need = 4;
+        return ECLIB_OK;
+    }
+    case RS_DICT_ID:
+        if (read32_le(p) != r->dict->id) return ECLIB_ECLIB_CORRUPT_DATA;
+        r->state = RS_BLOCK;
+        r->need = 4;
+        return ECLIB_OK;
+    case RS_BLOCK: {
+        uint32_t v = read32_le(p);
+        if (v == 0) {
+            if (r->flags & ECLIB_Z_CONTENT_CHECKSUM) {
+                r->state = RS_CONTENT_CRC;
+                r->need = 4;
+            } else {
+                r->state = RS_DONE;
+            }
+            return ECLIB_OK;
+        }
+        size_t size = v & ~RAW_BLOCK;
+        if (size == 0 ||
+            size > ((v & RAW_BLOCK) ? ECLIB_ZBLOCK_MAX : BLOCK_BOUND)) {
+            return ECLIB_ECLIB_CORRUPT_DATA;
+        }
+        r->block = v;
+        r->state = RS_DATA;
+        r->need = size + ((r->flags & ECLIB_Z_BLOCK_CHECKSUM) ? 4 : 0);
+        return ECLIB_OK;
+    }
+    case RS_DATA: {
+        size_t size = r->block & ~RAW_BLOCK;
+        const uint8_t* data = p;
+        size_t n = size;
+        if ((r->flags & ECLIB_Z_BLOCK_CHECKSUM) &&
+            eclib_crc32c(0, p, size) != read32_le(p + size)) {
+            return ECLIB_ECLIB_CORRUPT_DATA;
+        }
+        if (!(r->block & RAW_BLOCK)) {
+            if (lz_decompress(p, size, r->out, ECLIB_ZBLOCK_MAX, r->dict,
+                              &n) != ECLIB_OK) {
+                return ECLIB_ECLIB_CORRUPT_DATA;
+            }
+            data = r->out;
+        }
+        if (r->flags & ECLIB_Z_CONTENT_CHECKSUM) {
+            r->content_crc = eclib_crc32c(r->content_crc, data, n);
+        }
+        if (n) sink(ctx, (const char*)data, n);
+        r->state = RS_BLOCK;
+        r->need = 4;
+        return ECLIB_OK;
+    }
+    case RS_CONTENT_CRC:
+        if (read32_le(p) != r->content_crc) return ECLIB_ECLIB_CORRUPT_DATA;
+        r->state = RS_DONE;
+        return ECLIB_OK;
+    }
+    return ECLIB_ECLIB_CORRUPT_DATA;
+}
+
+eclib_err_t eclib_zreader_feed(eclib_zreader_t* r, const void* data,
+                               size_t len, eclib_sink_fn sink, void* ctx) {
+    const uint8_t* in = data;
+
+    if (r == NULL) return ECLIB_ECLIB_INVALID_PARAMETER;
+    if (r->err != ECLIB_OK) return r->err;
+    if ((in == NULL && len) || sink == NULL) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return ECLIB_ECLIB_INVALID_PARAMETER;
+    }
+    if (r->buf == NULL && len) {
+        r->buf = eclib_malloc(BLOCK_BUF + ECLIB_ZBLOCK_MAX);
+        if (r->buf == NULL) {
+            eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+            return ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY;
+        }
+        r->out = r->buf + BLOCK_BUF;
+    }
+    while (len) {
+        const uint8_t* p;
+        if (r->state == RS_DONE) {
+            r->err = ECLIB_ECLIB_CORRUPT_DATA;      // data after the frame
+            break;
+        }
+        if (r->have == 0 && len >= r->need) {
+            // Complete in the caller's buffer: no copy
+            p = in;
+            in += r->need;
+            len -= r->need;
+        } else {
+            size_t n = r->need - r->have;
+            if (n > len) n = len;
+            eclib_memcpy(r->buf + r->have, in, n);
+            r->have += n;
+            in += n;
+            len -= n;
+            if (r->have < r->need) break;
+            p = r->buf;
+            r->have = 0;
+        }
+        r->err = reader_step(r, p, sink, ctx);
+        if (r->err != ECLIB_OK) break;
+    }
+    if (r->err != ECLIB_OK) eclib_set_last_err(r->err);
+    return r->err;
+}
+
+eclib_err_t eclib_zreader_finish(eclib_zreader_t* r) {
+    if (r == NULL) return ECLIB_ECLIB_INVALID_PARAMETER;
+    eclib_free(r->buf);
+    r->buf = r->out = NULL;
+    if (r->err == ECLIB_OK && r->state != RS_DONE) {
+        r->err = ECLIB_ECLIB_CORRUPT_DATA;
+        eclib_set_last_err(r->err);
+    }
+    return r->err;
+}
@@ -1,4 +1,6 @@
 #include "ebts/printkit.h"
+#include "eclib/men.h"
+#include "eclib/utils.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -98,22 +100,22 @@ static void format_message(
     
     // 构建消息
     if (g_printkit.options.add_timestamp && g_printkit.options.add_process_info) {
-        snprintf(buffer, buffer_size, 
+        eclib_snprintf(buffer, buffer_size, 
                 "[%s.%06ld][PID:%d][%s] %s",
                 time_buf, tv.tv_usec,
                 pid,
                 level_str,
                 message);
     } else if (g_printkit.options.add_timestamp) {
-        snprintf(buffer, buffer_size,
+        eclib_snprintf(buffer, buffer_size,
                 "[%s] %s",
                 time_buf, message);
     } else if (g_printkit.options.add_process_info) {
-        snprintf(buffer, buffer_size,
+        eclib_snprintf(buffer, buffer_size,
                 "[PID:%d][%s] %s",
                 pid, level_str, message);
     } else {
-        snprintf(buffer, buffer_size, "%s", message);
+        eclib_snprintf(buffer, buffer_size, "%s", message);
     }
 }
 
@@ -181,4 +183,47 @@ static void terminal_print_internal(
             fflush(g_printkit.log_file);
         }
     }
-}
\ No newline at end of file
+}
+
+void TerminalPrint_MemoryStats(void) {
+    eclib_mem_stats_t stats;
+    eclib_mem_site_t sites[10];
+    char line[256];
+
+    eclib_mem_get_stats(&stats);
+    size_t site_count = eclib_mem_profile_sites(sites, 10);
+
+    eclib_snprintf(line, sizeof(line),
+             "内存统计: 分配 %llu 次, 存活 %llu 字节, IPC %llu 次, 采样 %llu 次 (间隔 %zu 字节)",
+             (unsigned long long)stats.allocs,
+             (unsigned long long)stats.live_bytes,
+             (unsigned long long)stats.ipc_calls,
+             (unsigned long long)stats.samples,
+             stats.sample_rate);
+    terminal_print_internal(LOG_LEVEL_INFO, line);
+
+    for (int i = 0; i < ECLIB_MEM_STAT_CLASSES; i++) {
+        const eclib_mem_class_stats_t* c = &stats.classes[i];
+        if (c->allocs == 0) continue;
+
+        char size_buf[16];
+        if (c->size) eclib_snprintf(size_buf, sizeof(size_buf), "%u", (unsigned)c->size);
+        else eclib_snprintf(size_buf, sizeof(size_buf), "large");
+        eclib_snprintf(line, sizeof(line),
+                 "  class %-6s 分配 %llu 释放 %llu 存活 %llu 峰值 %llu",
+                 size_buf,
+                 (unsigned long long)c->allocs,
+                 (unsigned long long)c->frees,
+                 (unsigned long long)c->live_bytes,
+                 (unsigned long long)c->peak_bytes);
+        terminal_print_internal(LOG_LEVEL_INFO, line);
+    }
+
+    for (size_t i = 0; i < site_count; i++) {
+        eclib_snprintf(line, sizeof(line), "  site %p 采样 %llu 字节 %llu",
+                 sites[i].site,
+                 (unsigned long long)sites[i].samples,
+                 (unsigned long long)sites[i].bytes);
+        terminal_print_internal(LOG_LEVEL_INFO, line);
+    }
+}
@@ -5,14 +5,221 @@
 #include "eclib/env.h"
 #include "eclib/utils.h"
 #include "eclib/men.h"
+#include "eclib/hashmap.h"
+#include "eclib/error.h"
+#include <pthread.h>
 
 char** eclib_environ = 0;
 
-char* eclib_getenv(const char* name) {
+// Serialises setenv/unsetenv and snapshot rebuilds. After a change the
+// published snapshot is marked stale and the next reader replaces it, so
+// a burst of writes costs one copy of the environment, not one each.
+static pthread_mutex_t g_env_lock = PTHREAD_MUTEX_INITIALIZER;
+static int g_env_stale;
+
+// Storage for what setenv adds. The pointer array grows geometrically in
+// place, and "NAME=VALUE" strings are carved out of an arena rather than
+// malloc'd one by one (every malloc may be an IPC to memory_manager).
+// Arrays and strings that did not come from here, such as the ones the
+// process started with, are never freed, only replaced. Entries that are
+// overwritten or unset leave dead bytes behind; once those outweigh the
+// live ones, the live entries are copied into a fresh arena.
+#define ENV_MIN_SLOTS       16
+#define ENV_COMPACT_MIN     (16 * 1024)
+
+static struct {
+    char** array;               // our array, cap slots including the NULL
+    size_t cap;
+    eclib_arena_t arena;        // entry strings
+    size_t live;                // arena bytes still referenced
+    size_t dead;                // arena bytes no longer referenced
+    int init;
+} g_env_store;
+
+// Name index: maps the part of each entry before '=' to its slot in
+// eclib_environ, so eclib_getenv does not compare against every entry.
+// Built on first use, kept up to date by setenv/unsetenv, and rebuilt
+// when the array it was built for (address and length) is no longer the
+// one in eclib_environ. A hit is checked against the slot it names before
+// it is trusted, which catches most direct stores into the array too.
+// Lookups may rebuild it, so every use holds g_env_lock.
+static struct {
+    eclib_hashmap_t map;        // name -> slot
+    char** environ;             // array the map describes
+    size_t count;               // its entries, without the NULL
+    int dups;                   // some name is set more than once
+    int valid;
+    int init;
+} g_env_index;
+
+void eclib_env_invalidate(void) {
+    pthread_mutex_lock(&g_env_lock);
+    g_env_index.valid = 0;
+    __atomic_store_n(&g_env_stale, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_env_lock);
+}
+
+static inline size_t env_slot(const eclib_hashmap_entry_t* e) {
+    return (size_t)(uintptr_t)e->value;
+}
+
+// Whether entry is name=...
+static inline int env_match(const char* entry, const char* name,
+                            size_t name_len) {
+    return eclib_strncmp(entry, name, name_len) == 0 &&
+           entry[name_len] == '=';
+}
+
+static int env_index_build(void) {
+    char** env = eclib_environ;
+    size_t count = 0;
+
+    if (!g_env_index.init) {
+        eclib_hashmap_init(&g_env_index.map,
+                           ECLIB_HASHMAP_STR | ECLIB_HASHMAP_COPY_KEYS, 0);
+        g_env_index.init = 1;
+    }
+    eclib_hashmap_clear(&g_env_index.map);
+    g_env_index.valid = 0;
+    g_env_index.dups = 0;
+    while (env[count]) count++;
+    if (eclib_hashmap_reserve(&g_env_index.map, count) != ECLIB_OK) return 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const char* eq = eclib_strchr(env[i], '=');
+        int inserted;
+        if (!eq) continue;
+        eclib_hashmap_entry_t* e = eclib_hashmap_insert_strn(
+            &g_env_index.map, env[i], (size_t)(eq - env[i]), &inserted);
+        if (!e) return 0;
+        // The first of two equal names is the one a scan finds
+        if (inserted) e->value = (void*)(uintptr_t)i;
+        else g_env_index.dups = 1;
+    }
+    g_env_index.environ = env;
+    g_env_index.count = count;
+    g_env_index.valid = 1;
+    return 1;
+}
+
+// Make the index describe eclib_environ (non-NULL)
+// Return: 0 if it cannot be built; callers then scan
+static int env_index_ready(void) {
+    char** env = eclib_environ;
+    size_t n = g_env_index.count;
+
+    if (g_env_index.valid && env == g_env_index.environ &&
+        env[n] == 0 && (n == 0 || env[n - 1] != 0)) {
+        return 1;
+    }
+    return env_index_build();
+}
+
+// Slot of name, -1 if it is not set; -2 if the index is unusable
+static long env_index_find(const char* name, size_t name_len) {
+    if (!env_index_ready()) return -2;
+    eclib_hashmap_entry_t* e =
+        eclib_hashmap_find_strn(&g_env_index.map, name, name_len);
+    if (!e) return -1;
+    size_t i = env_slot(e);
+    if (env_match(eclib_environ[i], name, name_len)) return (long)i;
+    // The slot was changed behind our back
+    g_env_index.valid = 0;
+    return -2;
+}
+
+// An entry is leaving eclib_environ: count its bytes as dead if it is ours
+static void env_release(const char* entry) {
+    if (!g_env_store.init || !eclib_arena_owns(&g_env_store.arena, entry)) {
+        return;
+    }
+    size_t len = eclib_strlen(entry) + 1;
+    g_env_store.live -= len < g_env_store.live ? len : g_env_store.live;
+    g_env_store.dead += len;
+}
+
+// Copy the live entries into a fresh arena once most of the old one is
+// dead. Only done while eclib_environ is our array, since nothing else
+// is known to be the only place that points at the entries. The index
+// keeps its own copies of the names, so it stays valid.
+static void env_compact(void) {
+    char** env = eclib_environ;
+    eclib_arena_t* old = &g_env_store.arena;
+
+    if (env != g_env_store.array || g_env_store.dead < ENV_COMPACT_MIN ||
+        g_env_store.dead <= g_env_store.live) {
+        return;
+    }
+
+    size_t live = 0;
+    for (size_t i = 0; env[i]; i++) {
+        if (eclib_arena_owns(old, env[i])) live += eclib_strlen(env[i]) + 1;
+    }
+
+    eclib_arena_t fresh;
+    eclib_arena_init(&fresh, ECLIB_ARENA_DEFAULT_CHUNK);
+    char* p = 0;
+    if (live) {
+        p = eclib_arena_alloc_aligned(&fresh, live, 1);
+        if (!p) return;         // keep the old arena, try again later
+    }
+    for (size_t i = 0; env[i]; i++) {
+        if (!eclib_arena_owns(old, env[i])) continue;
+        size_t len = eclib_strlen(env[i]) + 1;
+        eclib_memcpy(p, env[i], len);
+        env[i] = p;
+        p += len;
+    }
+    eclib_arena_destroy(old);
+    *old = fresh;
+    g_env_store.live = live;
+    g_env_store.dead = 0;
+}
+
+// Make eclib_environ our array with room for one more entry, count being
+// the number it holds now
+static int env_reserve(size_t count) {
+    char** env = eclib_environ;
+    int ours = env && env == g_env_store.array;
+
+    if (ours && count + 2 <= g_env_store.cap) return 1;
+
+    size_t cap = ours ? g_env_store.cap * 2 : ENV_MIN_SLOTS;
+    while (cap < count + 2) cap *= 2;
+
+    char** array;
+    if (ours) {
+        array = eclib_realloc(env, cap * sizeof(char*));
+        if (!array) return 0;
+    } else {
+        array = eclib_malloc(cap * sizeof(char*));
+        if (!array) return 0;
+        for (size_t i = 0; i < count; i++) array[i] = env[i];
+        array[count] = 0;
+        // Ours was replaced by whoever assigned eclib_environ
+        eclib_free(g_env_store.array);
+    }
+
+    if (g_env_index.valid && g_env_index.environ == env) {
+        g_env_index.environ = array;
+    }
+    g_env_store.array = array;
+    g_env_store.cap = cap;
+    // Snapshot readers compare against it without the lock
+    __atomic_store_n(&eclib_environ, array, __ATOMIC_RELAXED);
+    return 1;
+}
+
+// eclib_getenv with g_env_lock held: a lookup may rebuild the index
+static char* env_get(const char* name) {
     if (!name || !eclib_environ) return 0;
     
     size_t name_len = eclib_strlen(name);
-    
+    long slot = env_index_find(name, name_len);
+    if (slot == -2) slot = env_index_find(name, name_len);
+    if (slot >= 0) return &eclib_environ[slot][name_len + 1];
+    if (slot == -1) return 0;
+
     for (int i = 0; eclib_environ[i]; i++) {
         if (eclib_strncmp(eclib_environ[i], name, name_len) == 0 &&
             eclib_environ[i][name_len] == '=') {
@@ -23,73 +230,428 @@ char* eclib_getenv(const char* name) {
     return 0;
 }
 
-int eclib_setenv(const char* name, const char* value, int overwrite) {
+char* eclib_getenv(const char* name) {
+    pthread_mutex_lock(&g_env_lock);
+    char* value = env_get(name);
+    pthread_mutex_unlock(&g_env_lock);
+    return value;
+}
+
+static int env_set(const char* name, const char* value, int overwrite) {
     if (!name || !value || eclib_strchr(name, '=')) return -1;
     
     size_t name_len = eclib_strlen(name);
     size_t value_len = eclib_strlen(value);
     
     // Find existing
-    int idx = -1;
-    int count = 0;
+    long idx = -1;
+    size_t count = 0;
     if (eclib_environ) {
-        for (int i = 0; eclib_environ[i]; i++) {
-            if (eclib_strncmp(eclib_environ[i], name, name_len) == 0 &&
-                eclib_environ[i][name_len] == '=') {
-                if (!overwrite) return 0;
-                idx = i;
+        idx = env_index_find(name, name_len);
+        if (idx >= -1) {
+            if (idx >= 0 && !overwrite) return 0;
+            count = g_env_index.count;
+        } else {
+            idx = -1;
+            for (size_t i = 0; eclib_environ[i]; i++) {
+                if (eclib_strncmp(eclib_environ[i], name, name_len) == 0 &&
+                    eclib_environ[i][name_len] == '=') {
+                    if (!overwrite) return 0;
+                    idx = (long)i;
+                }
+                count++;
             }
-            count++;
         }
     }
     
-    char* new_entry = eclib_malloc(name_len + value_len + 2);
+    if (!g_env_store.init) {
+        eclib_arena_init(&g_env_store.arena, ECLIB_ARENA_DEFAULT_CHUNK);
+        g_env_store.init = 1;
+    }
+    size_t entry_len = name_len + value_len + 2;
+    char* new_entry = eclib_env_entry_arena(&g_env_store.arena, name, value);
     if (!new_entry) return -1;
     
-    eclib_memcpy(new_entry, name, name_len);
-    new_entry[name_len] = '=';
-    eclib_memcpy(new_entry + name_len + 1, value, value_len + 1);
-    
     if (idx >= 0) {
-        eclib_free(eclib_environ[idx]);
+        env_release(eclib_environ[idx]);
         eclib_environ[idx] = new_entry;
-    } else {
-        char** new_environ = eclib_malloc((count + 2) * sizeof(char*));
-        if (!new_environ) {
-            eclib_free(new_entry);
-            return -1;
-        }
-        
-        for (int i = 0; i < count; i++) {
-            new_environ[i] = eclib_environ[i];
+        g_env_store.live += entry_len;
+        env_compact();
+        return 0;
+    }
+
+    if (!env_reserve(count)) {
+        g_env_store.dead += entry_len;
+        return -1;
+    }
+    eclib_environ[count] = new_entry;
+    eclib_environ[count + 1] = 0;
+    g_env_store.live += entry_len;
+
+    if (g_env_index.valid && g_env_index.environ == eclib_environ &&
+        g_env_index.count == count) {
+        eclib_hashmap_entry_t* e = eclib_hashmap_insert_strn(
+            &g_env_index.map, name, name_len, 0);
+        if (e) {
+            e->value = (void*)(uintptr_t)count;
+            g_env_index.count = count + 1;
+        } else {
+            g_env_index.valid = 0;
         }
-        new_environ[count] = new_entry;
-        new_environ[count + 1] = 0;
-        
-        eclib_free(eclib_environ);
-        eclib_environ = new_environ;
     }
     
     return 0;
 }
 
-int eclib_unsetenv(const char* name) {
+// Remove slot i of the indexed array by moving the last entry into it,
+// fixing up the index for both names
+static void env_swap_remove(size_t i, const char* name, size_t name_len) {
+    char** env = eclib_environ;
+    eclib_hashmap_t* map = &g_env_index.map;
+    size_t last = g_env_index.count - 1;
+
+    eclib_hashmap_entry_t* e = eclib_hashmap_find_strn(map, name, name_len);
+    if (e) eclib_hashmap_erase(map, e);
+    env_release(env[i]);
+
+    if (i != last) {
+        const char* eq = eclib_strchr(env[last], '=');
+        if (eq) {
+            e = eclib_hashmap_find_strn(map, env[last],
+                                        (size_t)(eq - env[last]));
+            if (e && env_slot(e) == last) e->value = (void*)(uintptr_t)i;
+        }
+        env[i] = env[last];
+    }
+    env[last] = 0;
+    g_env_index.count = last;
+}
+
+static int env_unset(const char* name) {
     if (!name || !eclib_environ) return -1;
     
     size_t name_len = eclib_strlen(name);
+    long slot = env_index_find(name, name_len);
+    if (slot == -2) slot = env_index_find(name, name_len);
+    if (slot == -1) return 0;
+
+    // Moving the last entry forward would change which of two equal
+    // names comes first, so arrays with duplicates keep their order
+    if (slot >= 0 && !g_env_index.dups) {
+        env_swap_remove((size_t)slot, name, name_len);
+        env_compact();
+        return 0;
+    }
     
-    for (int i = 0; eclib_environ[i]; i++) {
+    for (int i = slot >= 0 ? (int)slot : 0; eclib_environ[i]; i++) {
         if (eclib_strncmp(eclib_environ[i], name, name_len) == 0 &&
             eclib_environ[i][name_len] == '=') {
-            eclib_free(eclib_environ[i]);
+            env_release(eclib_environ[i]);
             
             // Shift remaining entries
             for (int j = i; eclib_environ[j]; j++) {
                 eclib_environ[j] = eclib_environ[j + 1];
             }
+            g_env_index.valid = 0;
+            env_compact();
             return 0;
         }
     }
     
     return 0;
 }
+
+int eclib_setenv(const char* name, const char* value, int overwrite) {
+    pthread_mutex_lock(&g_env_lock);
+    int ret = env_set(name, value, overwrite);
+    if (ret == 0) __atomic_store_n(&g_env_stale, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_env_lock);
+    return ret;
+}
+
+int eclib_unsetenv(const char* name) {
+    pthread_mutex_lock(&g_env_lock);
+    int ret = env_unset(name);
+    if (ret == 0) __atomic_store_n(&g_env_stale, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_env_lock);
+    return ret;
+}
+
+// ---------------------
+// Snapshots
+// ---------------------
+// A snapshot is one heap block: the header, a NULL-terminated copy of the
+// entry pointers, an open-addressing index of their names (slot + 1, 0 for
+// empty, at most half full) and the strings. It never changes once
+// published.
+//
+// Reclamation is epoch based. Every thread that reads has a record; while
+// it holds a snapshot the record carries the global epoch it saw on
+// entry, otherwise 0. Replacing the snapshot bumps the epoch and tags the
+// old one with the epoch before the bump; it is freed once every record
+// is 0 or newer than the tag. These accesses are sequentially consistent,
+// so a reader whose record a writer saw as 0 loads the snapshot only after
+// the swap and cannot be holding the old one.
+#define ENV_SNAPSHOT_SEED   0x9E3779B97F4A7C15ull
+#define ENV_SNAPSHOT_SLOTS  8
+
+struct eclib_env_snapshot {
+    struct eclib_env_snapshot* next;    // retired list
+    uint64_t retired;                   // epoch it was replaced in
+    char** source;                      // eclib_environ it was made from
+    size_t count;
+    size_t mask;
+    uint32_t* index;
+    char* entries[];                    // count + 1
+};
+
+typedef struct env_reader {
+    struct env_reader* prev;
+    struct env_reader* next;
+    uint64_t epoch;                     // 0: not reading
+    unsigned depth;                     // nested snapshot calls
+    int registered;
+} env_reader_t;
+
+static __thread env_reader_t t_env_reader;
+
+// Fields besides epoch are used with g_env_lock held
+static struct {
+    eclib_env_snapshot_t* current;
+    eclib_env_snapshot_t* retired;
+    env_reader_t* readers;
+    uint64_t epoch;
+    pthread_key_t key;
+    pthread_once_t once;
+} g_env_rcu = { .epoch = 1, .once = PTHREAD_ONCE_INIT };
+
+static void env_reader_exit(void* arg) {
+    env_reader_t* r = arg;
+
+    pthread_mutex_lock(&g_env_lock);
+    if (r->prev) r->prev->next = r->next;
+    else g_env_rcu.readers = r->next;
+    if (r->next) r->next->prev = r->prev;
+    __atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+    r->depth = 0;
+    r->registered = 0;
+    pthread_mutex_unlock(&g_env_lock);
+}
+
+static void env_reader_make_key(void) {
+    pthread_key_create(&g_env_rcu.key, env_reader_exit);
+}
+
+static void env_reader_register(env_reader_t* r) {
+    pthread_once(&g_env_rcu.once, env_reader_make_key);
+    pthread_setspecific(g_env_rcu.key, r);
+
+    pthread_mutex_lock(&g_env_lock);
+    r->prev = NULL;
+    r->next = g_env_rcu.readers;
+    if (g_env_rcu.readers) g_env_rcu.readers->prev = r;
+    g_env_rcu.readers = r;
+    r->registered = 1;
+    pthread_mutex_unlock(&g_env_lock);
+}
+
+static inline size_t env_name_hash(const char* name, size_t len) {
+    return (size_t)eclib_hash_bytes(name, len, ENV_SNAPSHOT_SEED);
+}
+
+static void env_snapshot_insert(eclib_env_snapshot_t* snap, size_t i,
+                                size_t name_len) {
+    const char* name = snap->entries[i];
+    size_t h = env_name_hash(name, name_len) & snap->mask;
+
+    while (snap->index[h]) {
+        // The first of two equal names is the one getenv finds
+        if (env_match(snap->entries[snap->index[h] - 1], name, name_len)) {
+            return;
+        }
+        h = (h + 1) & snap->mask;
+    }
+    snap->index[h] = (uint32_t)i + 1;
+}
+
+// Copy eclib_environ into a new snapshot; g_env_lock held
+static eclib_env_snapshot_t* env_snapshot_build(void) {
+    char** env = eclib_environ;
+    size_t count = 0, bytes = 0;
+
+    if (env) {
+        for (; env[count]; count++) bytes += eclib_strlen(env[count]) + 1;
+    }
+    if (count >= UINT32_MAX / 2) return NULL;
+    size_t slots = ENV_SNAPSHOT_SLOTS;
+    while (slots < 2 * count) slots *= 2;
+
+    size_t head = sizeof(eclib_env_snapshot_t) + (count + 1) * sizeof(char*);
+    eclib_env_snapshot_t* snap =
+        eclib_malloc(head + slots * sizeof(uint32_t) + bytes);
+    if (!snap) return NULL;
+
+    snap->next = NULL;
+    snap->retired = 0;
+    snap->source = env;
+    snap->count = count;
+    snap->mask = slots - 1;
+    snap->index = (uint32_t*)((char*)snap + head);
+    eclib_memset(snap->index, 0, slots * sizeof(uint32_t));
+
+    char* p = (char*)(snap->index + slots);
+    for (size_t i = 0; i < count; i++) {
+        size_t len = eclib_strlen(env[i]) + 1;
+        eclib_memcpy(p, env[i], len);
+        snap->entries[i] = p;
+        const char* eq = eclib_strchr(p, '=');
+        if (eq) env_snapshot_insert(snap, i, (size_t)(eq - p));
+        p += len;
+    }
+    snap->entries[count] = NULL;
+    return snap;
+}
+
+// Free the retired snapshots no reader can still hold; g_env_lock held
+static void env_snapshot_reclaim(void) {
+    uint64_t oldest = UINT64_MAX;
+
+    for (env_reader_t* r = g_env_rcu.readers; r; r = r->next) {
+        uint64_t e = __atomic_load_n(&r->epoch, __ATOMIC_SEQ_CST);
+        if (e && e < oldest) oldest = e;
+    }
+
+    eclib_env_snapshot_t** link = &g_env_rcu.retired;
+    while (*link) {
+        eclib_env_snapshot_t* snap = *link;
+        if (snap->retired < oldest) {
+            *link = snap->next;
+            eclib_free(snap);
+        } else {
+            link = &snap->next;
+        }
+    }
+}
+
+// Replace the current snapshot with one of eclib_environ; g_env_lock held
+static int env_snapshot_publish(void) {
+    __atomic_store_n(&g_env_stale, 0, __ATOMIC_SEQ_CST);
+    eclib_env_snapshot_t* snap = env_snapshot_build();
+    if (!snap) {
+        __atomic_store_n(&g_env_stale, 1, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    eclib_env_snapshot_t* old =
+        __atomic_exchange_n(&g_env_rcu.current, snap, __ATOMIC_SEQ_CST);
+    if (old) {
+        old->retired = __atomic_fetch_add(&g_env_rcu.epoch, 1,
+                                          __ATOMIC_SEQ_CST);
+        old->next = g_env_rcu.retired;
+        g_env_rcu.retired = old;
+    }
+    env_snapshot_reclaim();
+    return 1;
+}
+
+static inline int env_snapshot_fresh(const eclib_env_snapshot_t* snap) {
+    return snap && !__atomic_load_n(&g_env_stale, __ATOMIC_ACQUIRE) &&
+           snap->source == __atomic_load_n(&eclib_environ, __ATOMIC_RELAXED);
+}
+
+const eclib_env_snapshot_t* eclib_env_snapshot(void) {
+    env_reader_t* r = &t_env_reader;
+
+    if (!r->registered) env_reader_register(r);
+    if (r->depth++ == 0) {
+        __atomic_store_n(&r->epoch,
+                         __atomic_load_n(&g_env_rcu.epoch, __ATOMIC_SEQ_CST),
+                         __ATOMIC_SEQ_CST);
+    }
+
+    eclib_env_snapshot_t* snap =
+        __atomic_load_n(&g_env_rcu.current, __ATOMIC_SEQ_CST);
+    if (env_snapshot_fresh(snap)) return snap;
+
+    pthread_mutex_lock(&g_env_lock);
+    if (!env_snapshot_fresh(g_env_rcu.current)) env_snapshot_publish();
+    // Still the old one if the copy could not be made
+    snap = g_env_rcu.current;
+    pthread_mutex_unlock(&g_env_lock);
+
+    if (!snap) {
+        if (--r->depth == 0) __atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+        eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+    }
+    return snap;
+}
+
+void eclib_env_snapshot_release(const eclib_env_snapshot_t* snap) {
+    env_reader_t* r = &t_env_reader;
+
+    if (!snap || r->depth == 0) return;
+    if (--r->depth == 0) __atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+}
+
+const char* eclib_env_snapshot_get(const eclib_env_snapshot_t* snap,
+                                   const char* name) {
+    if (!snap || !name) return NULL;
+
+    size_t name_len = eclib_strlen(name);
+    size_t h = env_name_hash(name, name_len) & snap->mask;
+    for (;;) {
+        uint32_t k = snap->index[h];
+        if (!k) return NULL;
+        const char* entry = snap->entries[k - 1];
+        if (env_match(entry, name, name_len)) return entry + name_len + 1;
+        h = (h + 1) & snap->mask;
+    }
+}
+
+char* const* eclib_env_snapshot_environ(const eclib_env_snapshot_t* snap,
+                                        size_t* count) {
+    if (!snap) return NULL;
+    if (count) *count = snap->count;
+    return snap->entries;
+}
+
+char* eclib_getenv_arena(eclib_arena_t* arena, const char* name) {
+    const eclib_env_snapshot_t* snap = eclib_env_snapshot();
+    if (!snap) return 0;
+    const char* value = eclib_env_snapshot_get(snap, name);
+    char* copy = value ? eclib_arena_strdup(arena, value) : 0;
+    eclib_env_snapshot_release(snap);
+    return copy;
+}
+
+char* eclib_env_entry_arena(eclib_arena_t* arena, const char* name, const char* value) {
+    if (!name || !value || eclib_strchr(name, '=')) return 0;
+    
+    size_t name_len = eclib_strlen(name);
+    size_t value_len = eclib_strlen(value);
+    
+    char* entry = eclib_arena_alloc_aligned(arena, name_len + value_len + 2, 1);
+    if (!entry) return 0;
+    
+    eclib_memcpy(entry, name, name_len);
+    entry[name_len] = '=';
+    eclib_memcpy(entry + name_len + 1, value, value_len + 1);
+    return entry;
+}
+
+char** eclib_environ_dup_arena(eclib_arena_t* arena) {
+    const eclib_env_snapshot_t* snap = eclib_env_snapshot();
+    if (!snap) return 0;
+    
+    size_t count;
+    char* const* env = eclib_env_snapshot_environ(snap, &count);
+    char** copy = eclib_arena_alloc(arena, (count + 1) * sizeof(char*));
+    
+    for (size_t i = 0; copy && i < count; i++) {
+        copy[i] = eclib_arena_strdup(arena, env[i]);
+        if (!copy[i]) copy = 0;
+    }
+    if (copy) copy[count] = 0;
+    eclib_env_snapshot_release(snap);
+    return copy;
+}
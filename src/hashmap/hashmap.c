@@ -0,0 +1,445 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/hashmap.h"
+#include "eclib/arena.h"
+#include "eclib/men.h"
+#include "eclib/error.h"
+#include "eclib/utils.h"
+
+// Control bytes: 0..127 for a full slot (the low 7 bits of its hash),
+// otherwise EMPTY or DELETED, both with the top bit set. The first GROUP
+// bytes are repeated after the last slot, so a group can be loaded at any
+// slot without wrapping. The rest of the hash picks the first group to
+// probe; groups after it follow triangular steps, which visit every
+// group once when the capacity is a power of two.
+#define GROUP               16
+#define CTRL_EMPTY          0x80
+#define CTRL_DELETED        0xFE
+#define MIN_CAPACITY        GROUP
+
+// Group masks have 1 << GROUP_SHIFT bits per slot, only the lowest set
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define GROUP_SHIFT         0
+
+static inline uint64_t group_match(const uint8_t* g, uint8_t h2) {
+    __m128i v = _mm_loadu_si128((const __m128i*)g);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)h2)));
+}
+
+static inline uint64_t group_empty(const uint8_t* g) {
+    return group_match(g, CTRL_EMPTY);
+}
+
+// Empty or deleted
+static inline uint64_t group_free(const uint8_t* g) {
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)g));
+}
+
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define GROUP_SHIFT         2
+
+static inline uint64_t group_mask(uint8x16_t m) {
+    uint8x8_t nib = vshrn_n_u16(vreinterpretq_u16_u8(m), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nib), 0) & 0x1111111111111111ull;
+}
+
+static inline uint64_t group_match(const uint8_t* g, uint8_t h2) {
+    return group_mask(vceqq_u8(vld1q_u8(g), vdupq_n_u8(h2)));
+}
+
+static inline uint64_t group_empty(const uint8_t* g) {
+    return group_match(g, CTRL_EMPTY);
+}
+
+static inline uint64_t group_free(const uint8_t* g) {
+    return group_mask(vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(g))));
+}
+
+#else
+#define GROUP_SHIFT         0
+
+static inline uint64_t group_match(const uint8_t* g, uint8_t h2) {
+    uint64_t m = 0;
+    for (int i = 0; i < GROUP; i++) m |= (uint64_t)(g[i] == h2) << i;
+    return m;
+}
+
+static inline uint64_t group_empty(const uint8_t* g) {
+    return group_match(g, CTRL_EMPTY);
+}
+
+static inline uint64_t group_free(const uint8_t* g) {
+    uint64_t m = 0;
+    for (int i = 0; i < GROUP; i++) m |= (uint64_t)(g[i] >> 7) << i;
+    return m;
+}
+#endif
+
+#define GROUP_FIRST(m)      ((size_t)__builtin_ctzll(m) >> GROUP_SHIFT)
+#define GROUP_LAST(m)       ((size_t)(63 - __builtin_clzll(m)) >> GROUP_SHIFT)
+
+static uint64_t g_hashmap_maps;
+
+// Largest number of full plus deleted slots: 7/8 of the table
+static inline size_t max_fill(size_t capacity) {
+    return capacity - capacity / 8;
+}
+
+static inline int is_u64(const eclib_hashmap_t* map) {
+    return (map->flags & ECLIB_HASHMAP_U64) != 0;
+}
+
+static inline uint64_t entry_hash(const eclib_hashmap_t* map,
+                                  const eclib_hashmap_entry_t* e) {
+    if (is_u64(map)) return eclib_hash_u64(e->key.u64, map->seed);
+    return eclib_hash_bytes(e->key.str, e->len, map->seed);
+}
+
+static inline void set_ctrl(eclib_hashmap_t* map, size_t i, uint8_t c) {
+    map->ctrl[i] = c;
+    if (i < GROUP) map->ctrl[map->capacity + i] = c;
+}
+
+// First empty or deleted slot on the probe path of hash
+static size_t find_free(const eclib_hashmap_t* map, uint64_t hash) {
+    size_t mask = map->capacity - 1;
+    size_t pos = (size_t)(hash >> 7) & mask;
+    for (size_t step = GROUP;; step += GROUP) {
+        uint64_t m = group_free(map->ctrl + pos);
+        if (m) return (pos + GROUP_FIRST(m)) & mask;
+        pos = (pos + step) & mask;
+    }
+}
+
+// Probe for hash; eq is evaluated with the candidate entry as e
+#define PROBE(map, hash, eq)                                                  \
+    do {                                                                      \
+        if ((map)->capacity == 0) return NULL;                                \
+        size_t mask_ = (map)->capacity - 1;                                   \
+        size_t pos_ = (size_t)((hash) >> 7) & mask_;                          \
+        uint8_t h2_ = (uint8_t)((hash) & 0x7F);                               \
+        for (size_t step_ = GROUP;; step_ += GROUP) {                         \
+            const uint8_t* g_ = (map)->ctrl + pos_;                           \
+            for (uint64_t m_ = group_match(g_, h2_); m_; m_ &= m_ - 1) {      \
+                eclib_hashmap_entry_t* e =                                    \
+                    &(map)->entries[(pos_ + GROUP_FIRST(m_)) & mask_];        \
+                if (eq) return e;                                             \
+            }                                                                 \
+            if (group_empty(g_)) return NULL;                                 \
+            pos_ = (pos_ + step_) & mask_;                                    \
+        }                                                                     \
+    } while (0)
+
+static eclib_hashmap_entry_t* find_str(const eclib_hashmap_t* map,
+                                       const char* key, size_t len,
+                                       uint64_t hash) {
+    PROBE(map, hash,
+          e->len == len && eclib_memcmp(e->key.str, key, len) == 0);
+}
+
+static eclib_hashmap_entry_t* find_u64(const eclib_hashmap_t* map,
+                                       uint64_t key, uint64_t hash) {
+    PROBE(map, hash, e->key.u64 == key);
+}
+
+// --------------------------
+// Storage
+// --------------------------
+static void* map_alloc(eclib_hashmap_t* map, size_t size) {
+    if (map->arena) return eclib_arena_alloc(map->arena, size);
+    return eclib_malloc(size);
+}
+
+static void map_free(eclib_hashmap_t* map, void* ptr) {
+    if (map->arena == NULL) eclib_free(ptr);
+}
+
+static inline int owns_keys(const eclib_hashmap_t* map) {
+    return !is_u64(map) && (map->flags & ECLIB_HASHMAP_COPY_KEYS);
+}
+
+// Rebuild into a table of new_cap slots, dropping deleted ones
+static eclib_err_t rehash(eclib_hashmap_t* map, size_t new_cap) {
+    size_t bytes = new_cap * sizeof(eclib_hashmap_entry_t) + new_cap + GROUP;
+    eclib_hashmap_entry_t* entries = map_alloc(map, bytes);
+    if (entries == NULL) {
+        eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+        return ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY;
+    }
+
+    eclib_hashmap_t old = *map;
+    map->entries = entries;
+    map->ctrl = (uint8_t*)(entries + new_cap);
+    map->capacity = new_cap;
+    eclib_memset(map->ctrl, CTRL_EMPTY, new_cap + GROUP);
+
+    for (size_t i = 0; i < old.capacity; i++) {
+        if (old.ctrl[i] & 0x80) continue;
+        uint64_t hash = entry_hash(map, &old.entries[i]);
+        size_t j = find_free(map, hash);
+        set_ctrl(map, j, (uint8_t)(hash & 0x7F));
+        map->entries[j] = old.entries[i];
+    }
+    map->growth_left = max_fill(new_cap) - map->size;
+    if (old.entries) map_free(map, old.entries);
+    return ECLIB_OK;
+}
+
+// Make sure one more slot can be taken from the empty ones
+static eclib_err_t make_room(eclib_hashmap_t* map) {
+    if (map->capacity == 0) return rehash(map, MIN_CAPACITY);
+    // Mostly tombstones: rebuilding in place is enough
+    if (map->size < max_fill(map->capacity) / 2) {
+        return rehash(map, map->capacity);
+    }
+    return rehash(map, map->capacity * 2);
+}
+
+// Claim a slot for a key known to be missing
+static eclib_hashmap_entry_t* claim(eclib_hashmap_t* map, uint64_t hash) {
+    size_t i = map->capacity ? find_free(map, hash) : 0;
+    if (map->capacity == 0 ||
+        (map->ctrl[i] == CTRL_EMPTY && map->growth_left == 0)) {
+        if (make_room(map) != ECLIB_OK) return NULL;
+        i = find_free(map, hash);
+    }
+    if (map->ctrl[i] == CTRL_EMPTY) map->growth_left--;
+    set_ctrl(map, i, (uint8_t)(hash & 0x7F));
+    map->size++;
+    return &map->entries[i];
+}
+
+// --------------------------
+// Map
+// --------------------------
+void eclib_hashmap_init(eclib_hashmap_t* map, uint32_t flags,
+                        eclib_arena_t* arena) {
+    if (map == NULL) return;
+    map->ctrl = NULL;
+    map->entries = NULL;
+    map->capacity = 0;
+    map->size = 0;
+    map->growth_left = 0;
+    map->flags = flags;
+    map->arena = arena;
+    // Different maps probe differently, so a bad key set for one table
+    // does not carry over to the next
+    uint64_t n = __atomic_add_fetch(&g_hashmap_maps, 1, __ATOMIC_RELAXED);
+    map->seed = eclib_hash_u64((uintptr_t)map, n);
+}
+
+static void free_keys(eclib_hashmap_t* map) {
+    if (!owns_keys(map) || map->arena) return;
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (!(map->ctrl[i] & 0x80)) eclib_free((void*)map->entries[i].key.str);
+    }
+}
+
+void eclib_hashmap_destroy(eclib_hashmap_t* map) {
+    if (map == NULL) return;
+    free_keys(map);
+    if (map->entries) map_free(map, map->entries);
+    map->ctrl = NULL;
+    map->entries = NULL;
+    map->capacity = 0;
+    map->size = 0;
+    map->growth_left = 0;
+}
+
+void eclib_hashmap_clear(eclib_hashmap_t* map) {
+    if (map == NULL || map->capacity == 0) return;
+    free_keys(map);
+    eclib_memset(map->ctrl, CTRL_EMPTY, map->capacity + GROUP);
+    map->size = 0;
+    map->growth_left = max_fill(map->capacity);
+}
+
+eclib_err_t eclib_hashmap_reserve(eclib_hashmap_t* map, size_t n) {
+    if (map == NULL) return ECLIB_ECLIB_INVALID_PARAMETER;
+    size_t cap = MIN_CAPACITY;
+    while (max_fill(cap) < n) {
+        if (cap > SIZE_MAX / 4 / (sizeof(eclib_hashmap_entry_t) + 1)) {
+            eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+            return ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY;
+        }
+        cap *= 2;
+    }
+    if (cap <= map->capacity) return ECLIB_OK;
+    return rehash(map, cap);
+}
+
+eclib_hashmap_entry_t* eclib_hashmap_find_strn(const eclib_hashmap_t* map,
+                                               const char* key, size_t len) {
+    if (map == NULL || key == NULL || is_u64(map)) return NULL;
+    return find_str(map, key, len, eclib_hash_bytes(key, len, map->seed));
+}
+
+eclib_hashmap_entry_t* eclib_hashmap_find_u64(const eclib_hashmap_t* map,
+                                              uint64_t key) {
+    if (map == NULL || !is_u64(map)) return NULL;
+    return find_u64(map, key, eclib_hash_u64(key, map->seed));
+}
+
+eclib_hashmap_entry_t* eclib_hashmap_insert_strn(eclib_hashmap_t* map,
+                                                 const char* key, size_t len,
+                                                 int* inserted) {
+    if (inserted) *inserted = 0;
+    if (map == NULL || key == NULL || is_u64(map)) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return NULL;
+    }
+    uint64_t hash = eclib_hash_bytes(key, len, map->seed);
+    eclib_hashmap_entry_t* e = find_str(map, key, len, hash);
+    if (e) return e;
+
+    const char* stored = key;
+    if (owns_keys(map)) {
+        char* copy = map_alloc(map, len + 1);
+        if (copy == NULL) {
+            eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+            return NULL;
+        }
+        eclib_memcpy(copy, key, len);
+        copy[len] = '\0';
+        stored = copy;
+    }
+    e = claim(map, hash);
+    if (e == NULL) {
+        if (stored != key) map_free(map, (void*)stored);
+        return NULL;
+    }
+    e->key.str = stored;
+    e->len = len;
+    e->value = NULL;
+    if (inserted) *inserted = 1;
+    return e;
+}
+
+eclib_hashmap_entry_t* eclib_hashmap_insert_u64(eclib_hashmap_t* map,
+                                                uint64_t key, int* inserted) {
+    if (inserted) *inserted = 0;
+    if (map == NULL || !is_u64(map)) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return NULL;
+    }
+    uint64_t hash = eclib_hash_u64(key, map->seed);
+    eclib_hashmap_entry_t* e = find_u64(map, key, hash);
+    if (e) return e;
+
+    e = claim(map, hash);
+    if (e == NULL) return NULL;
+    e->key.u64 = key;
+    e->len = 0;
+    e->value = NULL;
+    if (inserted) *inserted = 1;
+    return e;
+}
+
+void eclib_hashmap_erase(eclib_hashmap_t* map, eclib_hashmap_entry_t* entry) {
+    if (map == NULL || entry == NULL) return;
+    size_t i = (size_t)(entry - map->entries);
+    if (i >= map->capacity || (map->ctrl[i] & 0x80)) return;
+
+    if (owns_keys(map)) map_free(map, (void*)entry->key.str);
+
+    // If every group holding slot i also holds an empty slot, no probe
+    // can have passed over i, so it can go back to empty instead of
+    // leaving a tombstone
+    size_t mask = map->capacity - 1;
+    uint64_t before = group_empty(map->ctrl + ((i - GROUP) & mask));
+    uint64_t after = group_empty(map->ctrl + i);
+    size_t run = (after ? GROUP_FIRST(after) : GROUP) +
+                 (before ? GROUP - 1 - GROUP_LAST(before) : GROUP);
+    if (run < GROUP) {
+        set_ctrl(map, i, CTRL_EMPTY);
+        map->growth_left++;
+    } else {
+        set_ctrl(map, i, CTRL_DELETED);
+    }
+    map->size--;
+}
+
+eclib_hashmap_entry_t* eclib_hashmap_next(const eclib_hashmap_t* map,
+                                          size_t* iter) {
+    if (map == NULL || iter == NULL) return NULL;
+    size_t i = *iter;
+    while (i < map->capacity) {
+        // Full slots are the ones without the top bit
+        uint64_t full = ~group_free(map->ctrl + i);
+#if GROUP_SHIFT
+        full &= 0x1111111111111111ull;
+#else
+        full &= (1ull << GROUP) - 1;
+#endif
+        if (full) {
+            i += GROUP_FIRST(full);
+            if (i >= map->capacity) break;
+            *iter = i + 1;
+            return &map->entries[i];
+        }
+        i += GROUP;
+    }
+    *iter = map->capacity;
+    return NULL;
+}
+
+// --------------------------
+// Shorthands
+// --------------------------
+eclib_err_t eclib_hashmap_put_str(eclib_hashmap_t* map, const char* key,
+                                  void* value) {
+    if (key == NULL) return ECLIB_ECLIB_INVALID_PARAMETER;
+    eclib_hashmap_entry_t* e =
+        eclib_hashmap_insert_strn(map, key, eclib_strlen(key), NULL);
+    if (e == NULL) return eclib_get_last_err();
+    e->value = value;
+    return ECLIB_OK;
+}
+
+void* eclib_hashmap_get_str(const eclib_hashmap_t* map, const char* key) {
+    if (key == NULL) return NULL;
+    eclib_hashmap_entry_t* e = eclib_hashmap_find_strn(map, key, eclib_strlen(key));
+    return e ? e->value : NULL;
+}
+
+int eclib_hashmap_remove_str(eclib_hashmap_t* map, const char* key,
+                             void** value) {
+    if (key == NULL) return 0;
+    eclib_hashmap_entry_t* e = eclib_hashmap_find_strn(map, key, eclib_strlen(key));
+    if (e == NULL) return 0;
+    if (value) *value = e->value;
+    eclib_hashmap_erase(map, e);
+    return 1;
+}
+
+eclib_err_t eclib_hashmap_put_u64(eclib_hashmap_t* map, uint64_t key,
+                                  void* value) {
+    eclib_hashmap_entry_t* e = eclib_hashmap_insert_u64(map, key, NULL);
+    if (e == NULL) return eclib_get_last_err();
+    e->value = value;
+    return ECLIB_OK;
+}
+
+void* eclib_hashmap_get_u64(const eclib_hashmap_t* map, uint64_t key) {
+    eclib_hashmap_entry_t* e = eclib_hashmap_find_u64(map, key);
+    return e ? e->value : NULL;
+}
+
+int eclib_hashmap_remove_u64(eclib_hashmap_t* map, uint64_t key,
+                             void** value) {
+    eclib_hashmap_entry_t* e = eclib_hashmap_find_u64(map, key);
+    if (e == NULL) return 0;
+    if (value) *value = e->value;
+    eclib_hashmap_erase(map, e);
+    return 1;
+}
@@ -0,0 +1,193 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/intern.h"
+#include "eclib/arena.h"
+#include "eclib/men.h"
+#include "eclib/error.h"
+#include "eclib/utils.h"
+#include <pthread.h>
+
+// Atom n lives in record n - 1 of a chunked array that never moves, so a
+// reader can hold a record without a lock. The hash index is an array of
+// atoms with linear probing, kept at most half full. Writers fill a
+// record, then publish it with a release store of its slot; readers load
+// slots with acquire and see the finished record. Growing builds a new
+// index and swaps the pointer. The old one is not freed since a reader may
+// still be probing it; together they never exceed the size of the latest.
+// Strings and records come from an arena used only under the lock.
+
+#define ATOM_CHUNK_BITS     10
+#define ATOM_CHUNK          (1u << ATOM_CHUNK_BITS)
+#define ATOM_MAX_CHUNKS     4096
+#define ATOM_MAX            (ATOM_CHUNK * ATOM_MAX_CHUNKS)
+#define ATOM_MIN_INDEX      256
+#define ATOM_SEED           0x9E3779B97F4A7C15ull
+
+typedef struct {
+    const char* str;
+    uint32_t len;
+    uint32_t hash;
+} atom_rec_t;
+
+typedef struct {
+    size_t mask;
+    eclib_atom_t slots[];
+} atom_index_t;
+
+static atom_rec_t* g_atom_chunks[ATOM_MAX_CHUNKS];
+static uint32_t g_atom_count;
+static atom_index_t* g_atom_index;
+static eclib_arena_t g_atom_arena;
+static int g_atom_arena_ready;
+static pthread_mutex_t g_atom_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline const atom_rec_t* atom_rec(eclib_atom_t atom) {
+    uint32_t i = atom - 1;
+    atom_rec_t* chunk = __atomic_load_n(&g_atom_chunks[i >> ATOM_CHUNK_BITS],
+                                        __ATOMIC_ACQUIRE);
+    return &chunk[i & (ATOM_CHUNK - 1)];
+}
+
+static eclib_atom_t index_find(const atom_index_t* idx, const char* str,
+                               size_t len, uint32_t hash) {
+    size_t i = hash & idx->mask;
+    for (;;) {
+        eclib_atom_t a = __atomic_load_n(&idx->slots[i], __ATOMIC_ACQUIRE);
+        if (a == ECLIB_ATOM_NONE) return ECLIB_ATOM_NONE;
+        const atom_rec_t* r = atom_rec(a);
+        if (r->hash == hash && r->len == len &&
+            eclib_memcmp(r->str, str, len) == 0) {
+            return a;
+        }
+        i = (i + 1) & idx->mask;
+    }
+}
+
+static void index_put(atom_index_t* idx, eclib_atom_t atom, uint32_t hash) {
+    size_t i = hash & idx->mask;
+    while (idx->slots[i] != ECLIB_ATOM_NONE) i = (i + 1) & idx->mask;
+    __atomic_store_n(&idx->slots[i], atom, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t atom_hash(const char* str, size_t len) {
+    return (uint32_t)eclib_hash_bytes(str, len, ATOM_SEED);
+}
+
+eclib_atom_t eclib_atom_find_n(const char* str, size_t len) {
+    if (str == NULL) return ECLIB_ATOM_NONE;
+    const atom_index_t* idx = __atomic_load_n(&g_atom_index, __ATOMIC_ACQUIRE);
+    if (idx == NULL) return ECLIB_ATOM_NONE;
+    return index_find(idx, str, len, atom_hash(str, len));
+}
+
+eclib_atom_t eclib_atom_find(const char* str) {
+    if (str == NULL) return ECLIB_ATOM_NONE;
+    return eclib_atom_find_n(str, eclib_strlen(str));
+}
+
+// Add a new atom; called with the lock held
+static eclib_atom_t atom_add(const char* str, size_t len, uint32_t hash) {
+    uint32_t n = g_atom_count;
+    if (n >= ATOM_MAX) {
+        eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+        return ECLIB_ATOM_NONE;
+    }
+    if (!g_atom_arena_ready) {
+        eclib_arena_init(&g_atom_arena, 0);
+        g_atom_arena_ready = 1;
+    }
+
+    atom_index_t* idx = g_atom_index;
+    size_t want = idx ? idx->mask + 1 : ATOM_MIN_INDEX;
+    if ((size_t)(n + 1) * 2 > want) want *= 2;
+    atom_index_t* grown = NULL;
+    if (idx == NULL || want > idx->mask + 1) {
+        grown = eclib_calloc(1, sizeof(atom_index_t) + want * sizeof(eclib_atom_t));
+        if (grown == NULL) {
+            eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+            return ECLIB_ATOM_NONE;
+        }
+        grown->mask = want - 1;
+    }
+
+    atom_rec_t* chunk = g_atom_chunks[n >> ATOM_CHUNK_BITS];
+    if (chunk == NULL) {
+        chunk = eclib_arena_alloc(&g_atom_arena, ATOM_CHUNK * sizeof(atom_rec_t));
+    }
+    char* copy = chunk ? eclib_arena_alloc(&g_atom_arena, len + 1) : NULL;
+    if (copy == NULL) {
+        // A chunk allocated just now stays in the arena for the next try
+        if (chunk) __atomic_store_n(&g_atom_chunks[n >> ATOM_CHUNK_BITS],
+                                    chunk, __ATOMIC_RELEASE);
+        eclib_free(grown);
+        eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+        return ECLIB_ATOM_NONE;
+    }
+    eclib_memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    atom_rec_t* r = &chunk[n & (ATOM_CHUNK - 1)];
+    r->str = copy;
+    r->len = (uint32_t)len;
+    r->hash = hash;
+    __atomic_store_n(&g_atom_chunks[n >> ATOM_CHUNK_BITS], chunk,
+                     __ATOMIC_RELEASE);
+
+    eclib_atom_t atom = n + 1;
+    if (grown) {
+        for (eclib_atom_t a = 1; a <= n; a++) {
+            index_put(grown, a, atom_rec(a)->hash);
+        }
+        index_put(grown, atom, hash);
+        __atomic_store_n(&g_atom_index, grown, __ATOMIC_RELEASE);
+    } else {
+        index_put(idx, atom, hash);
+    }
+    __atomic_store_n(&g_atom_count, n + 1, __ATOMIC_RELEASE);
+    return atom;
+}
+
+eclib_atom_t eclib_intern_n(const char* str, size_t len) {
+    if (str == NULL || len > UINT32_MAX) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return ECLIB_ATOM_NONE;
+    }
+    uint32_t hash = atom_hash(str, len);
+    const atom_index_t* idx = __atomic_load_n(&g_atom_index, __ATOMIC_ACQUIRE);
+    eclib_atom_t atom = idx ? index_find(idx, str, len, hash) : ECLIB_ATOM_NONE;
+    if (atom != ECLIB_ATOM_NONE) return atom;
+
+    pthread_mutex_lock(&g_atom_lock);
+    // Someone may have added it since the lock-free look
+    idx = g_atom_index;
+    atom = idx ? index_find(idx, str, len, hash) : ECLIB_ATOM_NONE;
+    if (atom == ECLIB_ATOM_NONE) atom = atom_add(str, len, hash);
+    pthread_mutex_unlock(&g_atom_lock);
+    return atom;
+}
+
+eclib_atom_t eclib_intern(const char* str) {
+    if (str == NULL) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return ECLIB_ATOM_NONE;
+    }
+    return eclib_intern_n(str, eclib_strlen(str));
+}
+
+const char* eclib_atom_str(eclib_atom_t atom, size_t* len) {
+    if (atom == ECLIB_ATOM_NONE ||
+        atom > __atomic_load_n(&g_atom_count, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+    const atom_rec_t* r = atom_rec(atom);
+    if (len) *len = r->len;
+    return r->str;
+}
@@ -1,9 +1,9 @@
 #include "eclib/ipc_message.h" // Updated include directive
+#include "eclib/utils.h"
 #include <string.h>
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <time.h>
-#include <stdio.h>
 
 
 #define SYS_IPC_SEND          1001
@@ -70,7 +70,7 @@ int ipc_do_not_kill_sub(void) {
     if (ret == 0) {
         // 发送IPC消息通知PowerOffer
         char data[32];
-        snprintf(data, sizeof(data), "DO_NOT_KILL:%d", getpid());
+        eclib_snprintf(data, sizeof(data), "DO_NOT_KILL:%d", getpid());
         ipc_broadcast_msg(IPC_MSG_DO_NOT_KILL, 0, strlen(data), data);
     }
     
@@ -83,7 +83,7 @@ int ipc_do_not_kill_sub_emergency_ok(void) {
     
     if (ret == 0) {
         char data[32];
-        snprintf(data, sizeof(data), "DO_NOT_KILL_EMERGENCY:%d", getpid());
+        eclib_snprintf(data, sizeof(data), "DO_NOT_KILL_EMERGENCY:%d", getpid());
         ipc_broadcast_msg(IPC_MSG_DO_NOT_KILL, 0, strlen(data), data);
     }
     
@@ -9,11 +9,11 @@
  * (at your option) any later version.
  */
 #include "eclib/ipc_message.h"
+#include "eclib/utils.h"
 #include <string.h>
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <time.h>
-#include <stdio.h> // Added for snprintf
 
 // System call numbers
 #define SYS_IPC_SEND          1001
@@ -80,7 +80,7 @@ int ipc_do_not_kill_sub(void) {
     if (ret == 0) {
         // Send IPC message to notify PowerOffer
         char data[32];
-        snprintf(data, sizeof(data), "DO_NOT_KILL:%d", getpid());
+        eclib_snprintf(data, sizeof(data), "DO_NOT_KILL:%d", getpid());
         ipc_broadcast_msg(IPC_MSG_DO_NOT_KILL, 0, strlen(data), data);
     }
     
@@ -93,7 +93,7 @@ int ipc_do_not_kill_sub_emergency_ok(void) {
     
     if (ret == 0) {
         char data[32];
-        snprintf(data, sizeof(data), "DO_NOT_KILL_EMERGENCY:%d", getpid());
+        eclib_snprintf(data, sizeof(data), "DO_NOT_KILL_EMERGENCY:%d", getpid());
         ipc_broadcast_msg(IPC_MSG_DO_NOT_KILL, 0, strlen(data), data);
     }
     
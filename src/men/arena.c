@@ -0,0 +1,222 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/arena.h"
+#include "eclib/error.h"
+#include "eclib/utils.h"
+#include "men_internal.h"
+
+// Chunks form a singly linked list in the order they were first used.
+// Reset and rollback only move the cursor back; the chunks after it stay
+// linked and are picked up again by the next allocations that need them.
+// Chunks are mapped zero-filled and everything above "dirty" has never
+// been handed out, which lets eclib_arena_calloc skip clearing it.
+struct eclib_arena_chunk {
+    eclib_arena_chunk_t* next;
+    size_t size;                // bytes mapped, header included
+    char* dirty;                // high-water mark of handed-out memory
+};
+
+#define ARENA_CHUNK_HDR     32
+#define ARENA_ALIGN         16
+
+static inline char* chunk_data(eclib_arena_chunk_t* chunk) {
+    return (char*)chunk + ARENA_CHUNK_HDR;
+}
+
+static inline char* chunk_end(eclib_arena_chunk_t* chunk) {
+    return (char*)chunk + chunk->size;
+}
+
+static inline char* align_ptr(char* p, size_t align) {
+    return (char*)(((uintptr_t)p + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+// Records how far the cursor got in its chunk before it moves elsewhere
+static inline void arena_note_dirty(eclib_arena_t* arena) {
+    if (arena->cur && arena->ptr > arena->cur->dirty) {
+        arena->cur->dirty = arena->ptr;
+    }
+}
+
+void eclib_arena_init(eclib_arena_t* arena, size_t chunk_size) {
+    if (arena == NULL) return;
+    if (chunk_size == 0) chunk_size = ECLIB_ARENA_DEFAULT_CHUNK;
+
+    arena->first = NULL;
+    arena->cur = NULL;
+    arena->ptr = NULL;
+    arena->end = NULL;
+    arena->chunk_size = (chunk_size + ECLIB_PAGE_SIZE - 1) &
+                        ~(size_t)(ECLIB_PAGE_SIZE - 1);
+}
+
+void eclib_arena_destroy(eclib_arena_t* arena) {
+    if (arena == NULL) return;
+
+    eclib_arena_chunk_t* chunk = arena->first;
+    while (chunk) {
+        eclib_arena_chunk_t* next = chunk->next;
+        mem_release_pages(chunk, chunk->size);
+        chunk = next;
+    }
+    eclib_arena_init(arena, arena->chunk_size);
+}
+
+// Moves the cursor to the next chunk that can hold size bytes at align,
+// mapping a new one after the current chunk if the next is too small.
+static void* arena_grow(eclib_arena_t* arena, size_t size, size_t align) {
+    size_t need = size + align + ARENA_CHUNK_HDR;
+    eclib_arena_chunk_t* next = arena->cur ? arena->cur->next : arena->first;
+
+    if (next == NULL || next->size < need) {
+        size_t map_size = arena->chunk_size;
+        if (map_size < need) {
+            map_size = (need + ECLIB_PAGE_SIZE - 1) &
+                       ~(size_t)(ECLIB_PAGE_SIZE - 1);
+        }
+        eclib_arena_chunk_t* chunk = mem_map_pages(map_size, ECLIB_PAGE_SIZE,
+                                                   MEM_MAP_ZEROED);
+        if (chunk == NULL) return NULL;
+
+        chunk->size = map_size;
+        chunk->dirty = chunk_data(chunk);
+        chunk->next = next;
+        if (arena->cur) arena->cur->next = chunk;
+        else arena->first = chunk;
+        next = chunk;
+    }
+
+    arena_note_dirty(arena);
+    arena->cur = next;
+    arena->end = chunk_end(next);
+    char* p = align_ptr(chunk_data(next), align);
+    arena->ptr = p + size;
+    return p;
+}
+
+void* eclib_arena_alloc_aligned(eclib_arena_t* arena, size_t size, size_t align) {
+    if (arena == NULL || size == 0 || align == 0 || (align & (align - 1))) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return NULL;
+    }
+    if (size > SIZE_MAX / 2 || align > SIZE_MAX / 4) {
+        eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+        return NULL;
+    }
+
+    if (arena->ptr) {
+        char* p = align_ptr(arena->ptr, align);
+        if (p <= arena->end && size <= (size_t)(arena->end - p)) {
+            arena->ptr = p + size;
+            return p;
+        }
+    }
+    return arena_grow(arena, size, align);
+}
+
+void* eclib_arena_alloc(eclib_arena_t* arena, size_t size) {
+    return eclib_arena_alloc_aligned(arena, size, ARENA_ALIGN);
+}
+
+void* eclib_arena_calloc(eclib_arena_t* arena, size_t nmemb, size_t size) {
+    if (nmemb == 0 || size == 0) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return NULL;
+    }
+    size_t total_size = nmemb * size;
+    if (total_size / size != nmemb) {
+        eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+        return NULL;
+    }
+
+    char* ptr = eclib_arena_alloc(arena, total_size);
+    if (ptr == NULL) return NULL;
+
+    // Only the part below the chunk's high-water mark can be dirty
+    char* dirty = arena->cur->dirty;
+    if (ptr < dirty) {
+        size_t len = (size_t)(dirty - ptr);
+        eclib_memset(ptr, 0, len < total_size ? len : total_size);
+    }
+    return ptr;
+}
+
+eclib_arena_mark_t eclib_arena_mark(const eclib_arena_t* arena) {
+    eclib_arena_mark_t mark = {.chunk = arena->cur, .ptr = arena->ptr};
+    return mark;
+}
+
+void eclib_arena_rollback(eclib_arena_t* arena, eclib_arena_mark_t mark) {
+    arena_note_dirty(arena);
+    arena->cur = mark.chunk;
+    arena->ptr = mark.ptr;
+    arena->end = mark.chunk ? chunk_end(mark.chunk) : NULL;
+}
+
+void eclib_arena_reset(eclib_arena_t* arena) {
+    arena_note_dirty(arena);
+    arena->cur = NULL;
+    arena->ptr = NULL;
+    arena->end = NULL;
+}
+
+size_t eclib_arena_trim(eclib_arena_t* arena) {
+    if (arena == NULL) return 0;
+
+    // Every chunk past the cursor is idle until the arena grows again
+    eclib_arena_chunk_t** link = arena->cur ? &arena->cur->next : &arena->first;
+    eclib_arena_chunk_t* chunk = *link;
+    size_t bytes = 0;
+    *link = NULL;
+    while (chunk) {
+        eclib_arena_chunk_t* next = chunk->next;
+        bytes += chunk->size;
+        mem_release_pages(chunk, chunk->size);
+        chunk = next;
+    }
+    return bytes;
+}
+
+int eclib_arena_owns(const eclib_arena_t* arena, const void* p) {
+    if (arena == NULL || p == NULL) return 0;
+    for (eclib_arena_chunk_t* chunk = arena->first; chunk; chunk = chunk->next) {
+        if ((const char*)p >= chunk_data(chunk) &&
+            (const char*)p < chunk_end(chunk)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void* eclib_arena_memdup(eclib_arena_t* arena, const void* src, size_t len) {
+    if (src == NULL) return NULL;
+    void* dup = eclib_arena_alloc_aligned(arena, len ? len : 1, 1);
+    if (dup) eclib_memcpy(dup, src, len);
+    return dup;
+}
+
+char* eclib_arena_strndup(eclib_arena_t* arena, const char* s, size_t n) {
+    if (s == NULL) return NULL;
+    size_t len = 0;
+    while (len < n && s[len] != '\0') len++;
+
+    char* dup = eclib_arena_alloc_aligned(arena, len + 1, 1);
+    if (dup) {
+        eclib_memcpy(dup, s, len);
+        dup[len] = '\0';
+    }
+    return dup;
+}
+
+char* eclib_arena_strdup(eclib_arena_t* arena, const char* s) {
+    if (s == NULL) return NULL;
+    return eclib_arena_memdup(arena, s, eclib_strlen(s) + 1);
+}
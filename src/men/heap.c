@@ -0,0 +1,258 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "men_internal.h"
+#include "eclib/error.h"
+#include <pthread.h>
+
+// Size-class heap
+// ---------------
+// Small blocks are carved out of 64 KiB runs obtained from memory_manager in
+// one IPC. Each run serves a single size class; freed slots go back on the
+// run's own free list so an empty run can be handed back as a whole. Large
+// blocks get a dedicated run with the same header, so free() never needs to
+// ask memory_manager what it is holding.
+
+const uint32_t heap_class_size[HEAP_NUM_CLASSES] = {
+      16,   32,   48,   64,   80,   96,  112,  128,
+     160,  192,  224,  256,  320,  384,  448,  512,
+     640,  768,  896, 1024, 1280, 1536, 1792, 2048,
+    2560, 3072, 3584, 4096, 5120, 6144, 7168, 8192,
+};
+
+typedef struct {
+    pthread_mutex_t lock;
+    heap_run_t* avail;          // runs with at least one free slot
+    uint32_t run_count;
+} heap_class_t;
+
+static heap_class_t g_classes[HEAP_NUM_CLASSES] = {
+    [0 ... HEAP_NUM_CLASSES - 1] = { PTHREAD_MUTEX_INITIALIZER, NULL, 0 }
+};
+
+unsigned heap_size_to_class(size_t size) {
+    if (size <= 128) {
+        return size == 0 ? 0 : (unsigned)((size + 15) >> 4) - 1;
+    }
+    // 4 classes per power of two above 128
+    size_t n = size - 1;
+    unsigned lg = (unsigned)(63 - __builtin_clzll((unsigned long long)n));
+    return 8 + (lg - 7) * 4 + (unsigned)((n - ((size_t)1 << lg)) >> (lg - 2));
+}
+
+static void run_link(heap_class_t* c, heap_run_t* run) {
+    run->prev = NULL;
+    run->next = c->avail;
+    if (c->avail) c->avail->prev = run;
+    c->avail = run;
+}
+
+static void run_unlink(heap_class_t* c, heap_run_t* run) {
+    if (run->prev) run->prev->next = run->next;
+    else c->avail = run->next;
+    if (run->next) run->next->prev = run->prev;
+    run->prev = run->next = NULL;
+}
+
+static heap_run_t* run_new(unsigned cls) {
+    heap_run_t* run = mem_map_pages(HEAP_RUN_SIZE, HEAP_RUN_SIZE, 0);
+    if (run == NULL) return NULL;
+
+    uint32_t size = heap_class_size[cls];
+    run->magic = HEAP_RUN_MAGIC;
+    run->cls = (uint16_t)cls;
+    run->flags = 0;
+    run->map_size = HEAP_RUN_SIZE;
+    run->prev = run->next = NULL;
+    run->free_list = NULL;
+    run->bump = (char*)run + HEAP_RUN_HDR;
+    run->capacity = (HEAP_RUN_SIZE - HEAP_RUN_HDR) / size;
+    run->end = run->bump + (size_t)run->capacity * size;
+    run->used = 0;
+    return run;
+}
+
+// Hands out up to n slots of one class under a single lock acquisition.
+// Returns the number of slots written to out (0 only if mapping failed).
+unsigned heap_alloc_batch(unsigned cls, void** out, unsigned n) {
+    heap_class_t* c = &g_classes[cls];
+    uint32_t size = heap_class_size[cls];
+    unsigned got = 0;
+
+    pthread_mutex_lock(&c->lock);
+    while (got < n) {
+        heap_run_t* run = c->avail;
+        if (run == NULL) {
+            run = run_new(cls);
+            if (run == NULL) break;
+            run_link(c, run);
+            c->run_count++;
+        }
+
+        while (got < n && run->free_list) {
+            void* ptr = run->free_list;
+            run->free_list = *(void**)ptr;
+            out[got++] = ptr;
+            run->used++;
+        }
+        while (got < n && run->bump < run->end) {
+            out[got++] = run->bump;
+            run->bump += size;
+            run->used++;
+        }
+        if (run->used == run->capacity) {
+            run_unlink(c, run);
+            run->flags |= HEAP_RUN_FULL;
+        }
+    }
+    pthread_mutex_unlock(&c->lock);
+    return got;
+}
+
+// Returns n slots of one class to their runs under a single lock
+// acquisition; runs that become empty are unmapped after the lock drops.
+void heap_free_batch(unsigned cls, void* const* ptrs, unsigned n) {
+    heap_class_t* c = &g_classes[cls];
+    heap_run_t* release = NULL;
+
+    pthread_mutex_lock(&c->lock);
+    for (unsigned i = 0; i < n; i++) {
+        void* ptr = ptrs[i];
+        heap_run_t* run = heap_run_of(ptr);
+
+        *(void**)ptr = run->free_list;
+        run->free_list = ptr;
+        if (run->flags & HEAP_RUN_FULL) {
+            run->flags &= ~HEAP_RUN_FULL;
+            run_link(c, run);
+        }
+
+        // Keep the last run of a class mapped so a malloc/free ping-pong at
+        // the edge of a run does not turn into a map/unmap ping-pong.
+        if (--run->used == 0 && c->run_count > 1) {
+            run_unlink(c, run);
+            c->run_count--;
+            run->next = release;
+            release = run;
+        }
+    }
+    pthread_mutex_unlock(&c->lock);
+
+    while (release) {
+        heap_run_t* run = release;
+        release = run->next;
+        run->magic = 0;
+        mem_release_pages(run, run->map_size);
+    }
+}
+
+// Releases the empty run each class keeps mapped for reuse.
+// Returns the number of bytes queued for release.
+size_t heap_trim(void) {
+    size_t bytes = 0;
+
+    for (unsigned cls = 0; cls < HEAP_NUM_CLASSES; cls++) {
+        heap_class_t* c = &g_classes[cls];
+        heap_run_t* release = NULL;
+
+        pthread_mutex_lock(&c->lock);
+        heap_run_t* run = c->avail;
+        while (run) {
+            heap_run_t* next = run->next;
+            if (run->used == 0) {
+                run_unlink(c, run);
+                c->run_count--;
+                run->next = release;
+                release = run;
+            }
+            run = next;
+        }
+        pthread_mutex_unlock(&c->lock);
+
+        while (release) {
+            run = release;
+            release = run->next;
+            run->magic = 0;
+            bytes += run->map_size;
+            mem_release_pages(run, run->map_size);
+        }
+    }
+    return bytes;
+}
+
+// Pages needed for a large block plus its header; 0 on overflow
+static size_t large_map_size(size_t size) {
+    if (size > SIZE_MAX - HEAP_RUN_HDR - ECLIB_PAGE_SIZE) {
+        eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+        return 0;
+    }
+    return (size + HEAP_RUN_HDR + ECLIB_PAGE_SIZE - 1) &
+           ~(size_t)(ECLIB_PAGE_SIZE - 1);
+}
+
+static void* large_init(heap_run_t* run, size_t map_size) {
+    run->magic = HEAP_RUN_MAGIC;
+    run->cls = HEAP_CLASS_LARGE;
+    run->flags = 0;
+    run->map_size = map_size;
+    run->prev = run->next = NULL;
+    run->free_list = NULL;
+    run->bump = run->end = (char*)run + map_size;
+    run->used = run->capacity = 1;
+    return (char*)run + HEAP_RUN_HDR;
+}
+
+void* heap_alloc_large(size_t size, uint32_t map_flags) {
+    size_t map_size = large_map_size(size);
+    if (map_size == 0) return NULL;
+
+    heap_run_t* run = mem_map_pages(map_size, HEAP_RUN_SIZE, map_flags);
+    if (run == NULL) return NULL;
+    return large_init(run, map_size);
+}
+
+size_t heap_alloc_large_batch(size_t size, void** out, size_t n) {
+    size_t map_size = large_map_size(size);
+    if (map_size == 0) return 0;
+
+    size_t got = mem_map_pages_batch(map_size, HEAP_RUN_SIZE, 0, out, n);
+    for (size_t i = 0; i < got; i++) {
+        out[i] = large_init(out[i], map_size);
+    }
+    return got;
+}
+
+// Resizes a large block by remapping its pages, so the cost does not
+// depend on how much data it holds. The header travels with the pages.
+void* heap_realloc_large(heap_run_t* run, size_t size) {
+    size_t map_size = large_map_size(size);
+    if (map_size == 0) return NULL;
+    if (map_size == run->map_size) return (char*)run + HEAP_RUN_HDR;
+
+    heap_run_t* moved = mem_remap_pages(run, run->map_size, map_size,
+                                        HEAP_RUN_SIZE);
+    if (moved == NULL) return NULL;
+
+    moved->map_size = map_size;
+    moved->bump = moved->end = (char*)moved + map_size;
+    return (char*)moved + HEAP_RUN_HDR;
+}
+
+void heap_free_large(heap_run_t* run) {
+    run->magic = 0;
+    mem_release_pages(run, run->map_size);
+}
+
+size_t heap_usable_size(const heap_run_t* run) {
+    if (run->cls == HEAP_CLASS_LARGE) {
+        return run->map_size - HEAP_RUN_HDR;
+    }
+    return heap_class_size[run->cls];
+}
@@ -13,10 +13,22 @@
 #include "eclib/utils.h"
 #include "eclib/service.h"
 #include "eclib/ipc_message.h"
+#include "men_internal.h"
+#include <pthread.h>
 // Command codes agreed upon with the memory_manager service
 #define MEM_CMD_MALLOC  0x2001
 #define MEM_CMD_FREE    0x2002
 #define MEM_CMD_REALLOC 0x2003
+#define MEM_CMD_MAP     0x2004
+#define MEM_CMD_UNMAP   0x2005
+#define MEM_CMD_FREE_BATCH   0x2006
+#define MEM_CMD_MALLOC_BATCH 0x2007
+#define MEM_CMD_REMAP        0x2008
+
+// Batched requests are sized to fit one 256-byte IPC payload
+#define MEM_FREE_BATCH_MAX   15
+#define MEM_FREE_BATCH_BYTES (4 * HEAP_RUN_SIZE)
+#define MEM_MALLOC_BATCH_MAX 30
 
 typedef struct {
     size_t size;
@@ -41,70 +53,354 @@ typedef struct {
     eclib_err_t err;
 } mem_realloc_resp_t;
 
+typedef struct {
+    size_t size;                // multiple of ECLIB_PAGE_SIZE
+    size_t align;               // power of two, >= ECLIB_PAGE_SIZE
+    uint32_t flags;
+} mem_map_req_t;
+
+typedef struct {
+    void* addr;
+    eclib_err_t err;
+} mem_map_resp_t;
+
+typedef struct {
+    void* addr;
+    size_t size;
+} mem_unmap_req_t;
+
+typedef struct {
+    uint32_t count;
+    mem_unmap_req_t ranges[MEM_FREE_BATCH_MAX];
+} mem_free_batch_req_t;
+
+// Resize a mapping without copying: memory_manager extends or trims it in
+// place, or moves the pages to a new address with the same alignment.
+typedef struct {
+    void* old_addr;
+    size_t old_size;
+    size_t new_size;
+    size_t align;
+} mem_remap_req_t;
+
+typedef struct {
+    mem_map_req_t map;          // shared by every block in the batch
+    uint32_t count;
+} mem_malloc_batch_req_t;
+
+typedef struct {
+    eclib_err_t err;
+    uint32_t count;             // may be short of the requested count
+    void* addrs[MEM_MALLOC_BATCH_MAX];
+} mem_malloc_batch_resp_t;
+
 // Removed conflicting declaration of ipc_call_sync
 // Ensure the correct declaration from ipc_message.h is used.
 
-static uint32_t get_memory_manager_pid(void) {
-    return eclib_service_lookup("memory_manager");
-}
+// memory_manager does not move, so look it up once and only ask the
+// registry again after a call to it has failed.
+static uint32_t g_mem_pid = 0;
 
-// Memory Manager
-void* eclib_malloc(size_t size) {
-    if (size == 0) {
-        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
-        return NULL;
+static uint32_t get_memory_manager_pid(void) {
+    uint32_t pid = __atomic_load_n(&g_mem_pid, __ATOMIC_RELAXED);
+    if (pid == 0) {
+        pid = eclib_service_lookup("memory_manager");
+        __atomic_store_n(&g_mem_pid, pid, __ATOMIC_RELAXED);
     }
+    return pid;
+}
 
+static eclib_err_t mem_call(uint16_t cmd, const void* req, size_t req_len,
+                            void* resp, size_t* resp_len, uint32_t timeout_ms) {
     uint32_t mem_pid = get_memory_manager_pid();
     if (mem_pid == 0) {
-        eclib_set_last_err(ECLIB_ECLIB_CANNOT_FIND_MODULE);
-        return NULL;
+        return eclib_set_last_err(ECLIB_ECLIB_CANNOT_FIND_MODULE);
     }
 
-    mem_malloc_req_t req = {.size = size};
-    mem_malloc_resp_t resp;
-    size_t resp_len = sizeof(resp);
+    __atomic_fetch_add(&g_mem_ipc_calls, 1, __ATOMIC_RELAXED);
+    eclib_err_t err = ipc_call_sync(mem_pid, cmd, req, req_len,
+                                    resp, resp_len, timeout_ms);
+    if (err != ECLIB_OK) {
+        __atomic_store_n(&g_mem_pid, 0, __ATOMIC_RELAXED);
+        return eclib_set_last_err(err);
+    }
+    return ECLIB_OK;
+}
 
-    eclib_err_t err = ipc_call_sync(
-        mem_pid, MEM_CMD_MALLOC,
-        &req, sizeof(req),
-        &resp, &resp_len,
-        1000  // timeout 1s
-    );
+// -------------------------------
+// Page runs from memory_manager
+// -------------------------------
+void* mem_map_pages(size_t size, size_t align, uint32_t flags) {
+    mem_map_req_t req = {.size = size, .align = align, .flags = flags};
+    mem_map_resp_t resp;
+    size_t resp_len = sizeof(resp);
 
-    if (err != ECLIB_OK) {
-        eclib_set_last_err(err);
+    if (mem_call(MEM_CMD_MAP, &req, sizeof(req), &resp, &resp_len,
+                 1000) != ECLIB_OK) {
         return NULL;
     }
     if (resp.err != ECLIB_OK) {
         eclib_set_last_err(resp.err);
         return NULL;
     }
+    return resp.addr;
+}
+
+// Maps n equally sized page runs in ceil(n / MEM_MALLOC_BATCH_MAX) IPCs.
+// Returns how many were mapped; stops early if memory_manager runs dry.
+size_t mem_map_pages_batch(size_t size, size_t align, uint32_t flags,
+                           void** out, size_t n) {
+    size_t done = 0;
+    while (done < n) {
+        size_t want = n - done;
+        mem_malloc_batch_req_t req = {
+            .map = {.size = size, .align = align, .flags = flags},
+            .count = want < MEM_MALLOC_BATCH_MAX ? (uint32_t)want
+                                                 : MEM_MALLOC_BATCH_MAX
+        };
+        mem_malloc_batch_resp_t resp;
+        size_t resp_len = sizeof(resp);
+
+        if (mem_call(MEM_CMD_MALLOC_BATCH, &req, sizeof(req), &resp, &resp_len,
+                     1000) != ECLIB_OK) {
+            break;
+        }
+        if (resp.count > req.count) resp.count = req.count;
+        for (uint32_t i = 0; i < resp.count; i++) {
+            out[done++] = resp.addrs[i];
+        }
+        if (resp.err != ECLIB_OK || resp.count < req.count) {
+            eclib_set_last_err(resp.err != ECLIB_OK ? resp.err
+                                : ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+            break;
+        }
+    }
+    return done;
+}
+
+void* mem_remap_pages(void* addr, size_t old_size, size_t new_size, size_t align) {
+    mem_remap_req_t req = {
+        .old_addr = addr, .old_size = old_size,
+        .new_size = new_size, .align = align
+    };
+    mem_map_resp_t resp;
+    size_t resp_len = sizeof(resp);
 
+    if (mem_call(MEM_CMD_REMAP, &req, sizeof(req), &resp, &resp_len,
+                 1000) != ECLIB_OK) {
+        return NULL;
+    }
+    if (resp.err != ECLIB_OK) {
+        eclib_set_last_err(resp.err);
+        return NULL;
+    }
     return resp.addr;
 }
 
+static eclib_err_t mem_unmap_pages(void* addr, size_t size) {
+    mem_unmap_req_t req = {.addr = addr, .size = size};
+    return mem_call(MEM_CMD_UNMAP, &req, sizeof(req), NULL, NULL, 500);
+}
+
+// -------------------------------
+// Deferred page release
+// -------------------------------
+// Runs and large blocks given back by the heap are queued here and returned
+// to memory_manager MEM_FREE_BATCH_MAX ranges per IPC. Ranges that touch a
+// queued one are merged into it, so a teardown that frees neighbouring
+// blocks usually costs one entry. The queue is also sent once it holds
+// MEM_FREE_BATCH_BYTES, so a large block is never kept mapped waiting for
+// more frees.
+static struct {
+    pthread_mutex_t lock;
+    uint32_t count;
+    size_t bytes;
+    mem_unmap_req_t ranges[MEM_FREE_BATCH_MAX];
+} g_free_queue = { PTHREAD_MUTEX_INITIALIZER, 0, 0, {{0}} };
+
+// Bytes sent back so far; trims report the growth across their run
+static size_t g_pages_released;
+
+size_t mem_pages_released(void) {
+    return __atomic_load_n(&g_pages_released, __ATOMIC_RELAXED);
+}
+
+static void free_queue_send(const mem_free_batch_req_t* req) {
+    size_t bytes = 0;
+    for (uint32_t i = 0; i < req->count; i++) bytes += req->ranges[i].size;
+    __atomic_fetch_add(&g_pages_released, bytes, __ATOMIC_RELAXED);
+
+    if (req->count == 1) {
+        mem_unmap_pages(req->ranges[0].addr, req->ranges[0].size);
+    } else if (req->count > 1) {
+        mem_call(MEM_CMD_FREE_BATCH, req, sizeof(*req), NULL, NULL, 500);
+    }
+}
+
+void mem_release_pages(void* addr, size_t size) {
+    mem_free_batch_req_t req;
+    req.count = 0;
+
+    pthread_mutex_lock(&g_free_queue.lock);
+    uint32_t i;
+    for (i = 0; i < g_free_queue.count; i++) {
+        mem_unmap_req_t* r = &g_free_queue.ranges[i];
+        if ((char*)r->addr + r->size == (char*)addr) {
+            r->size += size;
+            break;
+        }
+        if ((char*)addr + size == (char*)r->addr) {
+            r->addr = addr;
+            r->size += size;
+            break;
+        }
+    }
+    if (i == g_free_queue.count) {
+        g_free_queue.ranges[g_free_queue.count++] =
+            (mem_unmap_req_t){.addr = addr, .size = size};
+    }
+    g_free_queue.bytes += size;
+    if (g_free_queue.count == MEM_FREE_BATCH_MAX ||
+        g_free_queue.bytes >= MEM_FREE_BATCH_BYTES) {
+        req.count = g_free_queue.count;
+        eclib_memcpy(req.ranges, g_free_queue.ranges,
+                     req.count * sizeof(req.ranges[0]));
+        g_free_queue.count = 0;
+        g_free_queue.bytes = 0;
+    }
+    pthread_mutex_unlock(&g_free_queue.lock);
+
+    free_queue_send(&req);
+}
+
+// Sends every queued range now; returns the number of bytes released
+size_t mem_flush_pages(void) {
+    mem_free_batch_req_t req;
+    size_t bytes = 0;
+
+    pthread_mutex_lock(&g_free_queue.lock);
+    req.count = g_free_queue.count;
+    for (uint32_t i = 0; i < req.count; i++) {
+        req.ranges[i] = g_free_queue.ranges[i];
+        bytes += req.ranges[i].size;
+    }
+    g_free_queue.count = 0;
+    g_free_queue.bytes = 0;
+    pthread_mutex_unlock(&g_free_queue.lock);
+
+    free_queue_send(&req);
+    return bytes;
+}
+
+// Validates a pointer handed back by the caller and returns its run
+static heap_run_t* run_from_user(void* addr) {
+    heap_run_t* run = heap_run_of(addr);
+    if (run->magic != HEAP_RUN_MAGIC) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return NULL;
+    }
+    return run;
+}
+
+// Allocation core shared by the public entry points; site is the caller
+// the sampler charges the block to.
+static void* mem_alloc(size_t size, void* site) {
+    if (size <= HEAP_MAX_SMALL) {
+        unsigned cls = heap_size_to_class(size);
+        void* ptr = tcache_alloc(cls);
+        if (ptr) prof_on_alloc(cls, 1, heap_class_size[cls], site);
+        return ptr;
+    }
+    void* ptr = heap_alloc_large(size, 0);
+    if (ptr) prof_on_alloc(MEM_STAT_LARGE, 1, heap_usable_size(heap_run_of(ptr)), site);
+    return ptr;
+}
+
+static void mem_free(heap_run_t* run, void* addr) {
+    if (run->cls == HEAP_CLASS_LARGE) {
+        prof_on_free(MEM_STAT_LARGE, heap_usable_size(run));
+        heap_free_large(run);
+    } else {
+        prof_on_free(run->cls, heap_class_size[run->cls]);
+        tcache_free(run->cls, addr);
+    }
+}
+
+// Memory Manager
+void* eclib_malloc(size_t size) {
+    if (size == 0) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return NULL;
+    }
+    return mem_alloc(size, __builtin_return_address(0));
+}
+
 void eclib_free(void* addr) {
     if (addr == NULL) return;
 
-    uint32_t mem_pid = get_memory_manager_pid();
-    if (mem_pid == 0) {
-        eclib_set_last_err(ECLIB_ECLIB_CANNOT_FIND_MODULE);
-        return;
+    heap_run_t* run = run_from_user(addr);
+    if (run == NULL) return;
+    mem_free(run, addr);
+}
+
+void eclib_free_sized(void* addr, size_t size) {
+    if (addr == NULL) return;
+
+    // The size picks the class; only large blocks need their header.
+    if (size != 0 && size <= HEAP_MAX_SMALL) {
+        unsigned cls = heap_size_to_class(size);
+        prof_on_free(cls, heap_class_size[cls]);
+        tcache_free(cls, addr);
+    } else {
+        eclib_free(addr);
     }
+}
 
-    mem_free_req_t req = {.addr = addr};
+size_t eclib_malloc_usable_size(void* addr) {
+    if (addr == NULL) return 0;
 
-    eclib_err_t err = ipc_call_sync(
-        mem_pid, MEM_CMD_FREE,
-        &req, sizeof(req),
-        NULL, NULL,
-        500  
-    );
-    
-    if (err != ECLIB_OK) {
-        eclib_set_last_err(err);
+    heap_run_t* run = run_from_user(addr);
+    return run ? heap_usable_size(run) : 0;
+}
+
+size_t eclib_malloc_batch(size_t n, size_t size, void** out) {
+    if (n == 0 || size == 0 || out == NULL) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return 0;
+    }
+
+    size_t done = 0;
+    unsigned row;
+    if (size <= HEAP_MAX_SMALL) {
+        // Straight from the class pool: one lock per 256 blocks
+        unsigned cls = heap_size_to_class(size);
+        while (done < n) {
+            unsigned want = n - done < 256 ? (unsigned)(n - done) : 256;
+            unsigned got = heap_alloc_batch(cls, out + done, want);
+            if (got == 0) break;
+            done += got;
+        }
+        row = cls;
+    } else {
+        done = heap_alloc_large_batch(size, out, n);
+        row = MEM_STAT_LARGE;
+    }
+    if (done == 0) return 0;
+
+    size_t block = heap_usable_size(heap_run_of(out[0]));
+    prof_on_alloc(row, done, done * block, __builtin_return_address(0));
+    if (done < n) {
+        for (size_t i = 0; i < done; i++) {
+            eclib_free(out[i]);
+        }
+        return 0;
     }
+    return n;
+}
+
+void eclib_free_flush(void) {
+    tcache_flush();
+    mem_flush_pages();
 }
 
 void* eclib_calloc(size_t nmemb, size_t size) {
@@ -120,10 +416,19 @@ void* eclib_calloc(size_t nmemb, size_t size) {
         return NULL;
     }
 
-    void* ptr = eclib_malloc(total_size);
-    if (ptr != NULL) {
-        eclib_memset(ptr, 0, total_size);
+    void* site = __builtin_return_address(0);
+    if (total_size <= HEAP_MAX_SMALL) {
+        void* ptr = mem_alloc(total_size, site);
+        if (ptr != NULL) {
+            heap_clear(ptr, (total_size + 15) & ~(size_t)15);
+        }
+        return ptr;
     }
+
+    // Large blocks always get fresh pages, so ask for zero-filled ones
+    // instead of clearing them again here.
+    void* ptr = heap_alloc_large(total_size, MEM_MAP_ZEROED);
+    if (ptr) prof_on_alloc(MEM_STAT_LARGE, 1, heap_usable_size(heap_run_of(ptr)), site);
     return ptr;
 }
 
@@ -132,38 +437,39 @@ void* eclib_realloc(void* ptr, size_t size) {
         eclib_free(ptr);
         return NULL;
     }
+    void* site = __builtin_return_address(0);
     if (ptr == NULL) {
-        return eclib_malloc(size);
+        return mem_alloc(size, site);
     }
 
-    uint32_t mem_pid = get_memory_manager_pid();
-    if (mem_pid == 0) {
-        eclib_set_last_err(ECLIB_ECLIB_CANNOT_FIND_MODULE);
-        return NULL;
-    }
-
-    mem_realloc_req_t req = {
-        .old_addr = ptr,
-        .new_size = size
-    };
-    mem_realloc_resp_t resp;
-    size_t resp_len = sizeof(resp);
-
-    eclib_err_t err = ipc_call_sync(
-        mem_pid, MEM_CMD_REALLOC,
-        &req, sizeof(req),
-        &resp, &resp_len,
-        1000
-    );
+    heap_run_t* run = run_from_user(ptr);
+    if (run == NULL) return NULL;
 
-    if (err != ECLIB_OK) {
-        eclib_set_last_err(err);
-        return NULL;
-    }
-    if (resp.err != ECLIB_OK) {
-        eclib_set_last_err(resp.err);
-        return NULL;
+    // Stay in place while the block still fits and the new size maps to
+    // the same kind of block, so eclib_free_sized() keeps working on it.
+    size_t old_size = heap_usable_size(run);
+    if (run->cls == HEAP_CLASS_LARGE) {
+        if (size > HEAP_MAX_SMALL && size <= old_size && size >= old_size / 2) {
+            return ptr;
+        }
+        // Large to large: move page mappings, never the bytes
+        if (size > HEAP_MAX_SMALL) {
+            void* new_ptr = heap_realloc_large(run, size);
+            if (new_ptr) {
+                prof_on_free(MEM_STAT_LARGE, old_size);
+                prof_on_alloc(MEM_STAT_LARGE, 1,
+                              heap_usable_size(heap_run_of(new_ptr)), site);
+                return new_ptr;
+            }
+        }
+    } else if (size <= HEAP_MAX_SMALL && heap_size_to_class(size) == run->cls) {
+        return ptr;
     }
 
-    return resp.new_addr;
-}
\ No newline at end of file
+    void* new_ptr = mem_alloc(size, site);
+    if (new_ptr == NULL) return NULL;
+
+    eclib_memcpy(new_ptr, ptr, size < old_size ? size : old_size);
+    mem_free(run, ptr);
+    return new_ptr;
+}
@@ -0,0 +1,133 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+// Private interface shared by the files under src/men. Not installed.
+#ifndef ECLIB_MEN_INTERNAL_H
+#define ECLIB_MEN_INTERNAL_H
+#include "eclib/error.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define ECLIB_PAGE_SIZE     4096
+
+// Every block handed out by the heap lives inside a "run": a HEAP_RUN_SIZE
+// aligned region mapped from memory_manager whose first cache line is a
+// heap_run_t header. Masking any user pointer with HEAP_RUN_MASK finds it.
+#define HEAP_RUN_SIZE       (64 * 1024)
+#define HEAP_RUN_MASK       (~(uintptr_t)(HEAP_RUN_SIZE - 1))
+#define HEAP_RUN_HDR        64
+#define HEAP_RUN_MAGIC      0x4543484Du  // "ECHM"
+
+// Small size classes: 16..128 step 16, then 4 classes per power of two
+#define HEAP_MAX_SMALL      8192
+#define HEAP_NUM_CLASSES    32
+#define HEAP_CLASS_LARGE    0xFFFF
+
+typedef struct heap_run {
+    uint32_t magic;
+    uint16_t cls;               // size class, or HEAP_CLASS_LARGE
+    uint16_t flags;
+    size_t   map_size;          // bytes mapped from memory_manager
+    struct heap_run* prev;      // links in the class "available" list
+    struct heap_run* next;
+    void*    free_list;         // recycled slots
+    char*    bump;              // first slot never handed out
+    char*    end;
+    uint32_t used;
+    uint32_t capacity;
+} heap_run_t;
+
+#define HEAP_RUN_FULL       0x0001
+
+static inline heap_run_t* heap_run_of(const void* ptr) {
+    return (heap_run_t*)((uintptr_t)ptr & HEAP_RUN_MASK);
+}
+
+// memory_manager page protocol (men.c)
+#define MEM_MAP_ZEROED      0x0001  // pages must read as zero
+void* mem_map_pages(size_t size, size_t align, uint32_t flags);
+size_t mem_map_pages_batch(size_t size, size_t align, uint32_t flags,
+                           void** out, size_t n);
+void* mem_remap_pages(void* addr, size_t old_size, size_t new_size, size_t align);
+void mem_release_pages(void* addr, size_t size);    // deferred, batched
+size_t mem_flush_pages(void);
+size_t mem_pages_released(void);    // bytes handed back so far, in total
+
+// Size-class heap (heap.c)
+extern const uint32_t heap_class_size[HEAP_NUM_CLASSES];
+unsigned heap_size_to_class(size_t size);
+unsigned heap_alloc_batch(unsigned cls, void** out, unsigned n);
+void heap_free_batch(unsigned cls, void* const* ptrs, unsigned n);
+void* heap_alloc_large(size_t size, uint32_t map_flags);
+size_t heap_alloc_large_batch(size_t size, void** out, size_t n);
+void* heap_realloc_large(heap_run_t* run, size_t size);
+void heap_free_large(heap_run_t* run);
+size_t heap_usable_size(const heap_run_t* run);
+size_t heap_trim(void);
+
+// Clears a block of whole 16-byte units; ptr must be 16-byte aligned
+static inline void heap_clear(void* ptr, size_t len) {
+    typedef uint64_t u64x2 __attribute__((vector_size(16)));
+    u64x2* p = ptr;
+    u64x2 zero = {0, 0};
+    for (size_t i = 0; i < len / 16; i++) {
+        p[i] = zero;
+    }
+}
+
+// Per-thread caches in front of the heap (tcache.c)
+void* tcache_alloc(unsigned cls);
+void tcache_free(unsigned cls, void* ptr);
+void tcache_flush(void);
+size_t tcache_trim(void);
+
+// Statistics and sampling (profile.c)
+#define MEM_STAT_LARGE      HEAP_NUM_CLASSES
+
+typedef struct mem_prof_tls {
+    uint64_t allocs[HEAP_NUM_CLASSES + 1];
+    uint64_t frees[HEAP_NUM_CLASSES + 1];
+    uint64_t large_alloc_bytes;
+    uint64_t large_free_bytes;
+    int64_t sample_countdown;   // bytes left until the next sample
+    uint64_t rng;
+    int registered;
+    struct mem_prof_tls* prev;
+    struct mem_prof_tls* next;
+} mem_prof_tls_t;
+
+extern __thread mem_prof_tls_t t_mem_prof;
+extern uint64_t g_mem_ipc_calls;
+
+void prof_register_thread(void);
+void prof_sample(size_t size, void* site);
+
+// Only the owning thread writes its counters; readers sum them racily
+static inline void prof_add(uint64_t* counter, uint64_t v) {
+    __atomic_store_n(counter, *counter + v, __ATOMIC_RELAXED);
+}
+
+static inline void prof_on_alloc(unsigned row, size_t n, size_t bytes, void* site) {
+    mem_prof_tls_t* t = &t_mem_prof;
+    if (!t->registered) prof_register_thread();
+    prof_add(&t->allocs[row], n);
+    if (row == MEM_STAT_LARGE) prof_add(&t->large_alloc_bytes, bytes);
+    t->sample_countdown -= (int64_t)bytes;
+    if (t->sample_countdown < 0) prof_sample(bytes, site);
+}
+
+static inline void prof_on_free(unsigned row, size_t bytes) {
+    mem_prof_tls_t* t = &t_mem_prof;
+    if (!t->registered) prof_register_thread();
+    prof_add(&t->frees[row], 1);
+    if (row == MEM_STAT_LARGE) prof_add(&t->large_free_bytes, bytes);
+}
+
+#endif // ECLIB_MEN_INTERNAL_H
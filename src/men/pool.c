@@ -0,0 +1,340 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/pool.h"
+#include "eclib/men.h"
+#include "eclib/error.h"
+#include "eclib/utils.h"
+#include "men_internal.h"
+
+// Slab layout: a power-of-two sized, self-aligned region whose first cache
+// line holds its number in the pool, followed by the slots. A slot index is
+// (slab number << 16) | slot within the slab, so index -> pointer is two
+// loads and a multiply, and pointer -> index needs no division.
+#define POOL_SLAB_MIN       (64 * 1024)
+#define POOL_SLAB_HDR       64
+#define POOL_SLAB_MAGIC     0x45435053u  // "ECPS"
+#define POOL_SLOT_BITS      16
+#define POOL_SLOT_MASK      ((1u << POOL_SLOT_BITS) - 1)
+#define POOL_MIN_SLOTS      16
+#define POOL_MAX_OBJ        (16u * 1024 * 1024)
+
+// Per-thread magazines
+#define POOL_MAG_SLOTS      8            // pools a thread can cache at once
+#define POOL_MAG_SIZE       32
+
+typedef struct {
+    uint32_t magic;
+    uint32_t slab_no;
+    uint32_t trim_free;         // scratch for eclib_pool_trim, under grow_lock
+} pool_slab_hdr_t;
+
+typedef struct {
+    eclib_pool_t* pool;
+    uint64_t pool_id;
+    uint32_t count;
+    uint32_t idx[POOL_MAG_SIZE];
+} pool_mag_t;
+
+static uint64_t g_pool_next_id = 1;
+
+static __thread pool_mag_t t_mags[POOL_MAG_SLOTS];
+static __thread int t_mags_registered;
+
+static pthread_key_t g_mag_key;
+static pthread_once_t g_mag_once = PTHREAD_ONCE_INIT;
+
+static inline char* slot_ptr(const eclib_pool_t* pool, uint32_t idx) {
+    char* slab = pool->slabs[idx >> POOL_SLOT_BITS];
+    return slab + POOL_SLAB_HDR + (size_t)(idx & POOL_SLOT_MASK) * pool->slot_size;
+}
+
+static inline uint32_t slot_index(const eclib_pool_t* pool, const void* obj) {
+    char* slab = (char*)((uintptr_t)obj & ~(uintptr_t)(pool->slab_size - 1));
+    uint64_t off = (uint64_t)((const char*)obj - slab - POOL_SLAB_HDR);
+    uint32_t slot = (uint32_t)((off * pool->slot_div) >> 32);
+    return (((pool_slab_hdr_t*)slab)->slab_no << POOL_SLOT_BITS) | slot;
+}
+
+// Next-free links live in the first 4 bytes of a free slot (index + 1)
+static inline uint32_t* slot_link(const eclib_pool_t* pool, uint32_t idx) {
+    return (uint32_t*)slot_ptr(pool, idx);
+}
+
+// Pushes the chain first..last (already linked through slot_link) in one CAS
+static void stack_push_chain(eclib_pool_t* pool, uint32_t first, uint32_t last) {
+    uint64_t old = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+    uint64_t new;
+    do {
+        __atomic_store_n(slot_link(pool, last), (uint32_t)old, __ATOMIC_RELAXED);
+        new = (((old >> 32) + 1) << 32) | (uint64_t)(first + 1);
+    } while (!__atomic_compare_exchange_n(&pool->head, &old, new, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Returns index + 1 of the popped slot, 0 if the stack is empty
+static uint32_t stack_pop(eclib_pool_t* pool) {
+    uint64_t old = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+    for (;;) {
+        uint32_t top = (uint32_t)old;
+        if (top == 0) return 0;
+        // The slot may be popped and reused under us; the tag makes the CAS
+        // below fail in that case, so whatever we read here is discarded.
+        uint32_t next = __atomic_load_n(slot_link(pool, top - 1), __ATOMIC_RELAXED);
+        uint64_t new = (((old >> 32) + 1) << 32) | next;
+        if (__atomic_compare_exchange_n(&pool->head, &old, new, 1,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            return top;
+        }
+    }
+}
+
+static eclib_err_t pool_grow(eclib_pool_t* pool) {
+    pthread_mutex_lock(&pool->grow_lock);
+
+    // Someone else may have refilled the stack while we waited
+    if ((uint32_t)__atomic_load_n(&pool->head, __ATOMIC_ACQUIRE) != 0) {
+        pthread_mutex_unlock(&pool->grow_lock);
+        return ECLIB_OK;
+    }
+    // Reuse a slab number freed by eclib_pool_trim before taking a new one
+    uint32_t slab_no = 0;
+    while (slab_no < pool->slab_count && pool->slabs[slab_no]) slab_no++;
+    if (slab_no == ECLIB_POOL_MAX_SLABS) {
+        pthread_mutex_unlock(&pool->grow_lock);
+        return eclib_set_last_err(ECLIB_ECLIB_RESOURCE_LIMIT);
+    }
+
+    char* slab = mem_map_pages(pool->slab_size, pool->slab_size, 0);
+    if (slab == NULL) {
+        pthread_mutex_unlock(&pool->grow_lock);
+        return eclib_get_last_err();
+    }
+    ((pool_slab_hdr_t*)slab)->magic = POOL_SLAB_MAGIC;
+    ((pool_slab_hdr_t*)slab)->slab_no = slab_no;
+    pool->slabs[slab_no] = slab;
+    if (slab_no == pool->slab_count) {
+        __atomic_store_n(&pool->slab_count, slab_no + 1, __ATOMIC_RELEASE);
+    }
+
+    uint32_t first = slab_no << POOL_SLOT_BITS;
+    uint32_t last = first + pool->slots_per_slab - 1;
+    for (uint32_t idx = first; idx < last; idx++) {
+        *slot_link(pool, idx) = idx + 2;
+    }
+    stack_push_chain(pool, first, last);
+
+    pthread_mutex_unlock(&pool->grow_lock);
+    return ECLIB_OK;
+}
+
+eclib_err_t eclib_pool_init(eclib_pool_t* pool, size_t obj_size, uint32_t flags) {
+    if (pool == NULL || obj_size == 0 || obj_size > POOL_MAX_OBJ) {
+        return eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+    }
+
+    size_t align = (flags & ECLIB_POOL_PACKED) ? 16 : 64;
+    size_t slot_size = (obj_size + align - 1) & ~(align - 1);
+
+    size_t slab_size = POOL_SLAB_MIN;
+    while ((slab_size - POOL_SLAB_HDR) / slot_size < POOL_MIN_SLOTS) {
+        slab_size <<= 1;
+    }
+
+    pool->slabs = eclib_calloc(ECLIB_POOL_MAX_SLABS, sizeof(char*));
+    if (pool->slabs == NULL) {
+        return eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);
+    }
+    pool->head = 0;
+    pool->id = __atomic_fetch_add(&g_pool_next_id, 1, __ATOMIC_RELAXED);
+    pool->flags = flags;
+    pool->obj_size = (uint32_t)obj_size;
+    pool->slot_size = (uint32_t)slot_size;
+    pool->slots_per_slab = (uint32_t)((slab_size - POOL_SLAB_HDR) / slot_size);
+    pool->slot_div = (uint32_t)(((1ull << 32) + slot_size - 1) / slot_size);
+    pool->slab_count = 0;
+    pool->slab_size = slab_size;
+    pthread_mutex_init(&pool->grow_lock, NULL);
+    return ECLIB_OK;
+}
+
+void eclib_pool_destroy(eclib_pool_t* pool) {
+    if (pool == NULL || pool->slabs == NULL) return;
+
+    eclib_pool_thread_flush(pool);
+    for (uint32_t i = 0; i < pool->slab_count; i++) {
+        if (pool->slabs[i]) mem_release_pages(pool->slabs[i], pool->slab_size);
+    }
+    eclib_free(pool->slabs);
+    pool->slabs = NULL;
+    pool->slab_count = 0;
+    pool->head = 0;
+    pthread_mutex_destroy(&pool->grow_lock);
+}
+
+size_t eclib_pool_trim(eclib_pool_t* pool) {
+    if (pool == NULL || pool->slabs == NULL) return 0;
+    pthread_mutex_lock(&pool->grow_lock);
+
+    // Take the whole free stack; frees racing with us push onto a new one
+    uint64_t old = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&pool->head, &old,
+                                        ((old >> 32) + 1) << 32, 1,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+    }
+
+    for (uint32_t i = 0; i < pool->slab_count; i++) {
+        if (pool->slabs[i]) ((pool_slab_hdr_t*)pool->slabs[i])->trim_free = 0;
+    }
+    for (uint32_t top = (uint32_t)old; top; top = *slot_link(pool, top - 1)) {
+        ((pool_slab_hdr_t*)pool->slabs[(top - 1) >> POOL_SLOT_BITS])->trim_free++;
+    }
+
+    // Relink the slots of the slabs that stay; a slab is only released
+    // when every one of its slots was on the stack.
+    uint32_t first = 0, last = 0;
+    for (uint32_t top = (uint32_t)old, next; top; top = next) {
+        next = *slot_link(pool, top - 1);
+        pool_slab_hdr_t* hdr =
+            (pool_slab_hdr_t*)pool->slabs[(top - 1) >> POOL_SLOT_BITS];
+        if (hdr->trim_free == pool->slots_per_slab) continue;
+        if (first) *slot_link(pool, last - 1) = top;
+        else first = top;
+        last = top;
+    }
+
+    size_t bytes = 0;
+    for (uint32_t i = 0; i < pool->slab_count; i++) {
+        pool_slab_hdr_t* hdr = (pool_slab_hdr_t*)pool->slabs[i];
+        if (hdr && hdr->trim_free == pool->slots_per_slab) {
+            pool->slabs[i] = NULL;
+            mem_release_pages(hdr, pool->slab_size);
+            bytes += pool->slab_size;
+        }
+    }
+    if (first) stack_push_chain(pool, first - 1, last - 1);
+
+    pthread_mutex_unlock(&pool->grow_lock);
+    return bytes;
+}
+
+// Hands the n coldest slots (the bottom of the magazine) back to the pool;
+// the recently freed ones stay cached for the next allocations.
+static void mag_release(pool_mag_t* mag, uint32_t n) {
+    uint32_t first = mag->idx[n - 1];
+    uint32_t last = mag->idx[0];
+    for (uint32_t i = n - 1; i > 0; i--) {
+        // A racing stack_pop may still read this link from an older pop
+        __atomic_store_n(slot_link(mag->pool, mag->idx[i]), mag->idx[i - 1] + 1,
+                         __ATOMIC_RELAXED);
+    }
+    stack_push_chain(mag->pool, first, last);
+    mag->count -= n;
+    eclib_memmove(mag->idx, mag->idx + n, mag->count * sizeof(mag->idx[0]));
+}
+
+static void mag_destroy(void* arg) {
+    (void)arg;
+    for (int i = 0; i < POOL_MAG_SLOTS; i++) {
+        pool_mag_t* mag = &t_mags[i];
+        if (mag->pool && mag->count && mag->pool->id == mag->pool_id) {
+            mag_release(mag, mag->count);
+        }
+        mag->pool = NULL;
+        mag->count = 0;
+    }
+    t_mags_registered = 0;
+}
+
+static void mag_make_key(void) {
+    pthread_key_create(&g_mag_key, mag_destroy);
+}
+
+// Finds (or claims) the calling thread's magazine for pool; NULL if this
+// thread already caches POOL_MAG_SLOTS other pools.
+static pool_mag_t* mag_get(eclib_pool_t* pool) {
+    pool_mag_t* spare = NULL;
+    for (int i = 0; i < POOL_MAG_SLOTS; i++) {
+        pool_mag_t* mag = &t_mags[i];
+        if (mag->pool == pool) {
+            if (mag->pool_id == pool->id) return mag;
+            mag->pool = NULL;       // left over from a destroyed pool
+            mag->count = 0;
+        }
+        if (mag->pool == NULL && spare == NULL) spare = mag;
+    }
+    if (spare == NULL) return NULL;
+
+    if (!t_mags_registered) {
+        pthread_once(&g_mag_once, mag_make_key);
+        pthread_setspecific(g_mag_key, t_mags);
+        t_mags_registered = 1;
+    }
+    spare->pool = pool;
+    spare->pool_id = pool->id;
+    spare->count = 0;
+    return spare;
+}
+
+void* eclib_pool_alloc(eclib_pool_t* pool) {
+    pool_mag_t* mag = NULL;
+    if (pool->flags & ECLIB_POOL_MAGAZINES) {
+        mag = mag_get(pool);
+        if (mag && mag->count) {
+            return slot_ptr(pool, mag->idx[--mag->count]);
+        }
+    }
+
+    for (;;) {
+        uint32_t top = stack_pop(pool);
+        if (top == 0) {
+            if (pool_grow(pool) != ECLIB_OK) return NULL;
+            continue;
+        }
+        // Refill half a magazine while we are here
+        if (mag) {
+            while (mag->count < POOL_MAG_SIZE / 2) {
+                uint32_t extra = stack_pop(pool);
+                if (extra == 0) break;
+                mag->idx[mag->count++] = extra - 1;
+            }
+        }
+        return slot_ptr(pool, top - 1);
+    }
+}
+
+void eclib_pool_free(eclib_pool_t* pool, void* obj) {
+    if (obj == NULL) return;
+    uint32_t idx = slot_index(pool, obj);
+
+    if (pool->flags & ECLIB_POOL_MAGAZINES) {
+        pool_mag_t* mag = mag_get(pool);
+        if (mag) {
+            if (mag->count == POOL_MAG_SIZE) {
+                mag_release(mag, POOL_MAG_SIZE / 2);
+            }
+            mag->idx[mag->count++] = idx;
+            return;
+        }
+    }
+    stack_push_chain(pool, idx, idx);
+}
+
+void eclib_pool_thread_flush(eclib_pool_t* pool) {
+    for (int i = 0; i < POOL_MAG_SLOTS; i++) {
+        pool_mag_t* mag = &t_mags[i];
+        if (mag->pool != pool) continue;
+        if (mag->count && mag->pool_id == pool->id) {
+            mag_release(mag, mag->count);
+        }
+        mag->pool = NULL;
+        mag->count = 0;
+    }
+}
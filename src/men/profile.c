@@ -0,0 +1,295 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/men.h"
+#include "men_internal.h"
+#include <pthread.h>
+
+// Heap statistics
+// ---------------
+// Every thread counts its own allocations and frees per size class in
+// t_mem_prof; a reader walks the list of live threads under g_prof.lock
+// and adds the totals of exited threads. The sampler is a byte countdown:
+// after a random number of bytes averaging the sample rate, the next
+// allocation is charged to its call site in a small hash table.
+
+#define PROF_SITE_SLOTS     1024
+#define PROF_IDLE_RECHECK   (64 * 1024 * 1024)  // countdown while sampling is off
+
+__thread mem_prof_tls_t t_mem_prof;
+uint64_t g_mem_ipc_calls = 0;
+
+static struct {
+    pthread_mutex_t lock;
+    mem_prof_tls_t* threads;
+    mem_prof_tls_t retired;                 // totals of exited threads
+    uint64_t peak[HEAP_NUM_CLASSES + 1];
+    uint64_t samples;
+    size_t rate;
+    eclib_mem_site_t sites[PROF_SITE_SLOTS];
+    uint32_t site_count;
+} g_prof = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .rate = ECLIB_MEM_PROFILE_RATE,
+};
+
+static pthread_key_t g_prof_key;
+static pthread_once_t g_prof_once = PTHREAD_ONCE_INIT;
+
+static uint64_t prof_rand(mem_prof_tls_t* t) {
+    // xorshift64*
+    uint64_t x = t->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    t->rng = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+// Uniform in [1, 2 * rate]: mean distance between samples is the rate
+static int64_t prof_next_countdown(mem_prof_tls_t* t) {
+    size_t rate = __atomic_load_n(&g_prof.rate, __ATOMIC_RELAXED);
+    if (rate == 0) return PROF_IDLE_RECHECK;
+    return (int64_t)(prof_rand(t) % (2 * (uint64_t)rate)) + 1;
+}
+
+static void prof_thread_exit(void* arg) {
+    mem_prof_tls_t* t = arg;
+
+    pthread_mutex_lock(&g_prof.lock);
+    for (unsigned i = 0; i <= HEAP_NUM_CLASSES; i++) {
+        g_prof.retired.allocs[i] += t->allocs[i];
+        g_prof.retired.frees[i] += t->frees[i];
+        t->allocs[i] = t->frees[i] = 0;
+    }
+    g_prof.retired.large_alloc_bytes += t->large_alloc_bytes;
+    g_prof.retired.large_free_bytes += t->large_free_bytes;
+    t->large_alloc_bytes = t->large_free_bytes = 0;
+
+    if (t->prev) t->prev->next = t->next;
+    else g_prof.threads = t->next;
+    if (t->next) t->next->prev = t->prev;
+    t->registered = 0;
+    pthread_mutex_unlock(&g_prof.lock);
+}
+
+static void prof_make_key(void) {
+    pthread_key_create(&g_prof_key, prof_thread_exit);
+}
+
+void prof_register_thread(void) {
+    mem_prof_tls_t* t = &t_mem_prof;
+
+    pthread_once(&g_prof_once, prof_make_key);
+    pthread_setspecific(g_prof_key, t);
+
+    t->rng = (uint64_t)(uintptr_t)t * 0x9E3779B97F4A7C15ull | 1;
+    t->sample_countdown = prof_next_countdown(t);
+
+    pthread_mutex_lock(&g_prof.lock);
+    t->prev = NULL;
+    t->next = g_prof.threads;
+    if (g_prof.threads) g_prof.threads->prev = t;
+    g_prof.threads = t;
+    t->registered = 1;
+    pthread_mutex_unlock(&g_prof.lock);
+}
+
+// Sums every thread's counters into stats; g_prof.lock must be held
+static void prof_collect(eclib_mem_stats_t* stats) {
+    uint64_t allocs[HEAP_NUM_CLASSES + 1];
+    uint64_t frees[HEAP_NUM_CLASSES + 1];
+    uint64_t large_in = g_prof.retired.large_alloc_bytes;
+    uint64_t large_out = g_prof.retired.large_free_bytes;
+
+    for (unsigned i = 0; i <= HEAP_NUM_CLASSES; i++) {
+        allocs[i] = g_prof.retired.allocs[i];
+        frees[i] = g_prof.retired.frees[i];
+    }
+    for (mem_prof_tls_t* t = g_prof.threads; t; t = t->next) {
+        for (unsigned i = 0; i <= HEAP_NUM_CLASSES; i++) {
+            allocs[i] += __atomic_load_n(&t->allocs[i], __ATOMIC_RELAXED);
+            frees[i] += __atomic_load_n(&t->frees[i], __ATOMIC_RELAXED);
+        }
+        large_in += __atomic_load_n(&t->large_alloc_bytes, __ATOMIC_RELAXED);
+        large_out += __atomic_load_n(&t->large_free_bytes, __ATOMIC_RELAXED);
+    }
+
+    stats->allocs = 0;
+    stats->live_bytes = 0;
+    for (unsigned i = 0; i <= HEAP_NUM_CLASSES; i++) {
+        eclib_mem_class_stats_t* c = &stats->classes[i];
+        c->size = i < HEAP_NUM_CLASSES ? heap_class_size[i] : 0;
+        c->allocs = allocs[i];
+        c->frees = frees[i];
+        // A block freed on another thread than its allocator can make a
+        // racy snapshot briefly show more frees than allocations.
+        if (i < HEAP_NUM_CLASSES) {
+            c->live_bytes = allocs[i] > frees[i] ?
+                            (allocs[i] - frees[i]) * c->size : 0;
+        } else {
+            c->live_bytes = large_in > large_out ? large_in - large_out : 0;
+        }
+        if (c->live_bytes > g_prof.peak[i]) g_prof.peak[i] = c->live_bytes;
+        c->peak_bytes = g_prof.peak[i];
+
+        stats->allocs += c->allocs;
+        stats->live_bytes += c->live_bytes;
+    }
+    stats->ipc_calls = __atomic_load_n(&g_mem_ipc_calls, __ATOMIC_RELAXED);
+    stats->samples = g_prof.samples;
+    stats->sample_rate = g_prof.rate;
+}
+
+static void prof_record_site(void* site, size_t size) {
+    uint32_t h = (uint32_t)(((uintptr_t)site * 0x9E3779B97F4A7C15ull) >> 54);
+    for (uint32_t i = 0; i < PROF_SITE_SLOTS; i++) {
+        eclib_mem_site_t* s = &g_prof.sites[(h + i) & (PROF_SITE_SLOTS - 1)];
+        if (s->site == site || s->site == NULL) {
+            if (s->site == NULL) {
+                // Keep one slot free so lookups always terminate
+                if (g_prof.site_count == PROF_SITE_SLOTS - 1) return;
+                s->site = site;
+                g_prof.site_count++;
+            }
+            s->samples++;
+            s->bytes += size;
+            return;
+        }
+    }
+}
+
+void prof_sample(size_t size, void* site) {
+    mem_prof_tls_t* t = &t_mem_prof;
+    t->sample_countdown = prof_next_countdown(t);
+    if (__atomic_load_n(&g_prof.rate, __ATOMIC_RELAXED) == 0) return;
+
+    eclib_mem_stats_t stats;
+    pthread_mutex_lock(&g_prof.lock);
+    g_prof.samples++;
+    prof_record_site(site, size);
+    prof_collect(&stats);           // refreshes the per-class peaks
+    pthread_mutex_unlock(&g_prof.lock);
+}
+
+void eclib_mem_get_stats(eclib_mem_stats_t* stats) {
+    if (stats == NULL) return;
+    pthread_mutex_lock(&g_prof.lock);
+    prof_collect(stats);
+    pthread_mutex_unlock(&g_prof.lock);
+}
+
+void eclib_mem_profile_set_rate(size_t bytes) {
+    __atomic_store_n(&g_prof.rate, bytes, __ATOMIC_RELAXED);
+    mem_prof_tls_t* t = &t_mem_prof;
+    if (t->registered) t->sample_countdown = prof_next_countdown(t);
+}
+
+size_t eclib_mem_profile_get_rate(void) {
+    return __atomic_load_n(&g_prof.rate, __ATOMIC_RELAXED);
+}
+
+size_t eclib_mem_profile_sites(eclib_mem_site_t* sites, size_t max) {
+    if (sites == NULL) return 0;
+    size_t n = 0;
+
+    pthread_mutex_lock(&g_prof.lock);
+    for (uint32_t i = 0; i < PROF_SITE_SLOTS; i++) {
+        const eclib_mem_site_t* s = &g_prof.sites[i];
+        if (s->site == NULL) continue;
+
+        // Insertion into the sorted output, dropping the lightest site
+        size_t pos = n < max ? n : max;
+        while (pos > 0 && sites[pos - 1].bytes < s->bytes) {
+            if (pos < max) sites[pos] = sites[pos - 1];
+            pos--;
+        }
+        if (pos < max) {
+            sites[pos] = *s;
+            if (n < max) n++;
+        }
+    }
+    pthread_mutex_unlock(&g_prof.lock);
+    return n;
+}
+
+// --------------------------
+// Text dump
+// --------------------------
+typedef struct {
+    char* buf;
+    size_t size;
+    size_t len;
+} prof_out_t;
+
+static void out_str(prof_out_t* out, const char* s) {
+    for (; *s; s++, out->len++) {
+        if (out->len + 1 < out->size) out->buf[out->len] = *s;
+    }
+}
+
+static void out_u64(prof_out_t* out, uint64_t v, unsigned base) {
+    char tmp[24];
+    int i = 0;
+    do {
+        tmp[i++] = "0123456789abcdef"[v % base];
+        v /= base;
+    } while (v);
+    char s[25];
+    int n = 0;
+    while (i > 0) s[n++] = tmp[--i];
+    s[n] = '\0';
+    out_str(out, s);
+}
+
+static void out_field(prof_out_t* out, const char* name, uint64_t v) {
+    out_str(out, name);
+    out_u64(out, v, 10);
+}
+
+size_t eclib_mem_profile_dump(char* buf, size_t size) {
+    prof_out_t out = {.buf = buf, .size = buf ? size : 0, .len = 0};
+    eclib_mem_stats_t stats;
+    eclib_mem_get_stats(&stats);
+
+    out_str(&out, "eclib-heap-profile 1\n");
+    out_field(&out, "rate ", stats.sample_rate);
+    out_field(&out, " samples ", stats.samples);
+    out_field(&out, " ipc ", stats.ipc_calls);
+    out_field(&out, " allocs ", stats.allocs);
+    out_field(&out, " live ", stats.live_bytes);
+    out_str(&out, "\n");
+
+    for (unsigned i = 0; i < ECLIB_MEM_STAT_CLASSES; i++) {
+        const eclib_mem_class_stats_t* c = &stats.classes[i];
+        if (c->allocs == 0) continue;
+        out_field(&out, "class ", c->size);
+        out_field(&out, " allocs ", c->allocs);
+        out_field(&out, " frees ", c->frees);
+        out_field(&out, " live ", c->live_bytes);
+        out_field(&out, " peak ", c->peak_bytes);
+        out_str(&out, "\n");
+    }
+
+    pthread_mutex_lock(&g_prof.lock);
+    for (uint32_t i = 0; i < PROF_SITE_SLOTS; i++) {
+        const eclib_mem_site_t* s = &g_prof.sites[i];
+        if (s->site == NULL) continue;
+        out_str(&out, "site 0x");
+        out_u64(&out, (uint64_t)(uintptr_t)s->site, 16);
+        out_field(&out, " samples ", s->samples);
+        out_field(&out, " bytes ", s->bytes);
+        out_str(&out, "\n");
+    }
+    pthread_mutex_unlock(&g_prof.lock);
+
+    if (out.size) out.buf[out.len < out.size ? out.len : out.size - 1] = '\0';
+    return out.len;
+}
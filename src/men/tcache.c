@@ -0,0 +1,153 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "men_internal.h"
+#include <pthread.h>
+
+// Per-thread caches
+// -----------------
+// Each thread keeps a bounded free list per size class. malloc/free touch
+// only that list; the shared class pools in heap.c are entered once per
+// TCACHE_BATCH objects, to refill an empty bin or to hand back half of a
+// full one. A block freed by another thread simply lands in the freeing
+// thread's cache and flows back to the shared pool with its next batch.
+// A trim drains the calling thread at once; other threads notice the new
+// trim generation the next time they refill or spill a bin.
+
+#define TCACHE_BATCH_MAX    32
+
+typedef struct {
+    void* head;
+    uint32_t count;
+} tcache_bin_t;
+
+typedef struct {
+    tcache_bin_t bins[HEAP_NUM_CLASSES];
+    uint32_t trim_gen;
+    int registered;
+} tcache_t;
+
+static __thread tcache_t t_cache;
+static uint32_t g_tcache_trim_gen = 0;
+
+static pthread_key_t g_tcache_key;
+static pthread_once_t g_tcache_once = PTHREAD_ONCE_INIT;
+
+// Bin limits scale down with the class size so one idle thread never
+// sits on more than a few runs' worth of memory.
+static inline uint32_t bin_limit(unsigned cls) {
+    uint32_t size = heap_class_size[cls];
+    if (size <= 256) return 2 * TCACHE_BATCH_MAX;
+    if (size <= 1024) return TCACHE_BATCH_MAX;
+    return 8;
+}
+
+static void bin_release(unsigned cls, tcache_bin_t* bin, uint32_t n) {
+    void* batch[2 * TCACHE_BATCH_MAX];
+    for (uint32_t i = 0; i < n; i++) {
+        batch[i] = bin->head;
+        bin->head = *(void**)bin->head;
+    }
+    bin->count -= n;
+    heap_free_batch(cls, batch, n);
+}
+
+// Returns the number of bytes handed back
+static size_t tcache_drain(tcache_t* tc) {
+    size_t bytes = 0;
+    tc->trim_gen = __atomic_load_n(&g_tcache_trim_gen, __ATOMIC_RELAXED);
+    for (unsigned cls = 0; cls < HEAP_NUM_CLASSES; cls++) {
+        tcache_bin_t* bin = &tc->bins[cls];
+        bytes += (size_t)bin->count * heap_class_size[cls];
+        while (bin->count) {
+            uint32_t n = bin->count < 2 * TCACHE_BATCH_MAX ?
+                         bin->count : 2 * TCACHE_BATCH_MAX;
+            bin_release(cls, bin, n);
+        }
+    }
+    return bytes;
+}
+
+// Drains the cache if a trim was requested since it was last drained
+static inline void tcache_check_trim(tcache_t* tc) {
+    if (__builtin_expect(tc->trim_gen !=
+                         __atomic_load_n(&g_tcache_trim_gen, __ATOMIC_RELAXED), 0)) {
+        tcache_drain(tc);
+    }
+}
+
+static void tcache_destroy(void* arg) {
+    tcache_t* tc = arg;
+    tcache_drain(tc);
+    tc->registered = 0;
+}
+
+static void tcache_make_key(void) {
+    pthread_key_create(&g_tcache_key, tcache_destroy);
+}
+
+// Hooks the cache up for flushing at thread exit on first use
+static void tcache_register(tcache_t* tc) {
+    pthread_once(&g_tcache_once, tcache_make_key);
+    pthread_setspecific(g_tcache_key, tc);
+    tc->trim_gen = __atomic_load_n(&g_tcache_trim_gen, __ATOMIC_RELAXED);
+    tc->registered = 1;
+}
+
+void* tcache_alloc(unsigned cls) {
+    tcache_bin_t* bin = &t_cache.bins[cls];
+    void* ptr = bin->head;
+    if (ptr) {
+        bin->head = *(void**)ptr;
+        bin->count--;
+        return ptr;
+    }
+
+    if (!t_cache.registered) tcache_register(&t_cache);
+    tcache_check_trim(&t_cache);
+
+    // Refill: keep one slot for the caller, cache the rest
+    void* batch[TCACHE_BATCH_MAX];
+    uint32_t want = bin_limit(cls) / 2;
+    unsigned got = heap_alloc_batch(cls, batch, want);
+    if (got == 0) return NULL;
+
+    for (unsigned i = 1; i < got; i++) {
+        *(void**)batch[i] = bin->head;
+        bin->head = batch[i];
+    }
+    bin->count += got - 1;
+    return batch[0];
+}
+
+void tcache_free(unsigned cls, void* ptr) {
+    tcache_bin_t* bin = &t_cache.bins[cls];
+    uint32_t limit = bin_limit(cls);
+    if (!t_cache.registered) tcache_register(&t_cache);
+    if (bin->count >= limit) {
+        tcache_check_trim(&t_cache);
+        if (bin->count >= limit) bin_release(cls, bin, limit / 2);
+    }
+    *(void**)ptr = bin->head;
+    bin->head = ptr;
+    bin->count++;
+}
+
+// Returns everything the calling thread has cached to the shared pools
+void tcache_flush(void) {
+    tcache_drain(&t_cache);
+}
+
+// Asks every thread to drop its cache; only the calling thread's bytes
+// can be counted here.
+size_t tcache_trim(void) {
+    __atomic_fetch_add(&g_tcache_trim_gen, 1, __ATOMIC_RELAXED);
+    return tcache_drain(&t_cache);
+}
@@ -0,0 +1,167 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/men.h"
+#include "eclib/error.h"
+#include "eclib/utils.h"
+#include "men_internal.h"
+#include <pthread.h>
+
+// Trim callbacks
+// --------------
+// A fixed table kept sorted by priority, highest first. A trim copies the
+// table under the lock and runs the copy without it, so callbacks may
+// allocate, free or (un)register. trim_lock keeps two trims from running
+// the same callbacks concurrently.
+//
+// The built-in steps pass memory down a chain: the thread caches into the
+// heap runs, empty runs into the page queue, the queue to memory_manager.
+// Each reports only the bytes that left the process while it ran, so a
+// range is counted once, by the step that sent it.
+
+static size_t trim_tcache(uint32_t level, void* user_data) {
+    (void)level;
+    (void)user_data;
+    size_t before = mem_pages_released();
+    tcache_trim();
+    return mem_pages_released() - before;
+}
+
+static size_t trim_heap(uint32_t level, void* user_data) {
+    (void)level;
+    (void)user_data;
+    size_t before = mem_pages_released();
+    heap_trim();
+    return mem_pages_released() - before;
+}
+
+static size_t trim_pages(uint32_t level, void* user_data) {
+    (void)level;
+    (void)user_data;
+    size_t before = mem_pages_released();
+    mem_flush_pages();
+    return mem_pages_released() - before;
+}
+
+typedef struct {
+    eclib_mem_trim_fn fn;
+    void* user_data;
+    int priority;
+} trim_entry_t;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_mutex_t trim_lock;
+    uint32_t count;
+    trim_entry_t entries[ECLIB_MEM_TRIM_MAX];
+} g_trim = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .trim_lock = PTHREAD_MUTEX_INITIALIZER,
+    .count = 3,
+    .entries = {
+        { trim_tcache, NULL, ECLIB_MEM_TRIM_PRIO_TCACHE },
+        { trim_heap,   NULL, ECLIB_MEM_TRIM_PRIO_HEAP },
+        { trim_pages,  NULL, ECLIB_MEM_TRIM_PRIO_PAGES },
+    },
+};
+
+eclib_err_t eclib_mem_register_trim(eclib_mem_trim_fn fn, void* user_data,
+                                    int priority) {
+    if (fn == NULL) {
+        return eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+    }
+
+    pthread_mutex_lock(&g_trim.lock);
+    for (uint32_t i = 0; i < g_trim.count; i++) {
+        if (g_trim.entries[i].fn == fn && g_trim.entries[i].user_data == user_data) {
+            pthread_mutex_unlock(&g_trim.lock);
+            return eclib_set_last_err(ECLIB_ECLIB_INVALID_OPERATION);
+        }
+    }
+    if (g_trim.count == ECLIB_MEM_TRIM_MAX) {
+        pthread_mutex_unlock(&g_trim.lock);
+        return eclib_set_last_err(ECLIB_ECLIB_RESOURCE_LIMIT);
+    }
+
+    // Behind every entry of the same priority, so equal ones run in
+    // registration order
+    uint32_t pos = g_trim.count;
+    while (pos > 0 && g_trim.entries[pos - 1].priority < priority) {
+        g_trim.entries[pos] = g_trim.entries[pos - 1];
+        pos--;
+    }
+    g_trim.entries[pos] = (trim_entry_t){fn, user_data, priority};
+    g_trim.count++;
+    pthread_mutex_unlock(&g_trim.lock);
+    return ECLIB_OK;
+}
+
+eclib_err_t eclib_mem_unregister_trim(eclib_mem_trim_fn fn, void* user_data) {
+    pthread_mutex_lock(&g_trim.lock);
+    for (uint32_t i = 0; i < g_trim.count; i++) {
+        if (g_trim.entries[i].fn != fn || g_trim.entries[i].user_data != user_data) {
+            continue;
+        }
+        g_trim.count--;
+        for (; i < g_trim.count; i++) {
+            g_trim.entries[i] = g_trim.entries[i + 1];
+        }
+        pthread_mutex_unlock(&g_trim.lock);
+        return ECLIB_OK;
+    }
+    pthread_mutex_unlock(&g_trim.lock);
+    return eclib_set_last_err(ECLIB_ECLIB_CANNOT_FIND_RESOURCE);
+}
+
+size_t eclib_mem_trim(uint32_t level) {
+    trim_entry_t entries[ECLIB_MEM_TRIM_MAX];
+    uint32_t count;
+    size_t bytes = 0;
+
+    pthread_mutex_lock(&g_trim.trim_lock);
+    pthread_mutex_lock(&g_trim.lock);
+    count = g_trim.count;
+    for (uint32_t i = 0; i < count; i++) {
+        entries[i] = g_trim.entries[i];
+    }
+    pthread_mutex_unlock(&g_trim.lock);
+
+    for (uint32_t i = 0; i < count; i++) {
+        bytes += entries[i].fn(level, entries[i].user_data);
+    }
+    pthread_mutex_unlock(&g_trim.trim_lock);
+    return bytes;
+}
+
+eclib_err_t eclib_mem_handle_pressure(const ipc_message_t* msg) {
+    if (msg == NULL || msg->type != IPC_MSG_MEMORY_PRESSURE) {
+        return eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+    }
+
+    // A message without a payload asks for the mildest trim
+    uint32_t level = IPC_MEMORY_PRESSURE_LOW;
+    if (msg->data_len >= sizeof(ipc_memory_pressure_t)) {
+        ipc_memory_pressure_t req;
+        eclib_memcpy(&req, msg->data, sizeof(req));
+        level = req.level;
+    }
+
+    ipc_memory_trimmed_t resp = {
+        .level = level,
+        .reserved = 0,
+        .bytes_freed = eclib_mem_trim(level),
+    };
+    int ret = ipc_send_msg(IPC_MSG_MEMORY_TRIMMED, 0, msg->sender_pid,
+                           sizeof(resp), &resp);
+    if (ret < 0) {
+        return eclib_set_last_err(ECLIB_IPC_SERVICE_UNAVAIL);
+    }
+    return ECLIB_OK;
+}
@@ -10,9 +10,8 @@
  */
 #include "eclib/rui.h" // Corrected include path
 #include "eclib/service.h" // Added for eclib_service_lookup
-#include "eclib/utils.h" // Added for eclib_strncpy
+#include "eclib/utils.h" // Added for eclib_utf8_strncpy
 #include "eclib/ipc_message.h"
-#include <string.h> // Added for memcpy
 
 // Global variable: RUI service PID (valid after initialization)
 static uint32_t g_rui_pid = 0;
@@ -42,8 +41,8 @@ uint32_t eclib_rui_create_window(const rui_point_t* pos, const rui_size_t* size,
     rui_window_create_req_t req;
     req.pos = *pos;
     req.size = *size;
-    eclib_strncpy(req.title, title, sizeof(req.title)-1);
-    req.title[sizeof(req.title)-1] = '\0';
+    // Long UTF-8 is cut between characters, never inside one
+    eclib_utf8_strncpy(req.title, title, sizeof(req.title));
     req.bg_color = *bg_color;
 
     // Synchronous call to RUI service
@@ -74,8 +73,7 @@ eclib_err_t eclib_rui_draw_text(uint32_t window_id, const rui_point_t* pos,
     rui_draw_text_req_t req;
     req.window_id = window_id;
     req.pos = *pos;
-    eclib_strncpy(req.text, text, sizeof(req.text)-1);
-    req.text[sizeof(req.text)-1] = '\0';
+    eclib_utf8_strncpy(req.text, text, sizeof(req.text));
     req.color = *color;
     req.font_size = font_size;
 
@@ -101,7 +99,7 @@ eclib_err_t eclib_rui_wait_event(rui_event_t* event, uint32_t timeout_ms) {
 
     eclib_err_t err = ipc_recv(&msg, timeout_ms);
     if (err == ECLIB_OK && msg.data_len == sizeof(rui_event_t)) {
-        memcpy(event, msg.data, sizeof(rui_event_t));
+        eclib_memcpy(event, msg.data, sizeof(rui_event_t));
     } else {
         err = ECLIB_IPC_BUFFER_OVERFLOW;
     }
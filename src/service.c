@@ -1,13 +1,16 @@
 #include "eclib/service.h"
 #include "eclib/ipc_message.h"
+#include "eclib/utils.h"
+#include "eclib/intern.h"
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
-#include <stdio.h> // Added for snprintf
 
-// Service registration table
+// Service registration table. atoms[i] is the interned name of
+// services[i], so name lookups compare integers.
 static struct service_registry {
     struct service_info services[256];
+    eclib_atom_t atoms[256];
     int count;
     int next_id;
 } g_registry = {0};
@@ -21,14 +24,20 @@ int service_register(const char* name) {
         return -2;  // Registration table full
     }
     
+    eclib_atom_t atom = eclib_intern(name);
+    if (atom == ECLIB_ATOM_NONE) {
+        return -1;
+    }
+
     // Check if already registered
     for (int i = 0; i < g_registry.count; i++) {
-        if (strcmp(g_registry.services[i].name, name) == 0) {
+        if (g_registry.atoms[i] == atom) {
             return -3;  // Already exists
         }
     }
     
     // Register new service
+    g_registry.atoms[g_registry.count] = atom;
     struct service_info* svc = &g_registry.services[g_registry.count];
     svc->id = g_registry.next_id++;
     strcpy(svc->name, name);
@@ -41,7 +50,7 @@ int service_register(const char* name) {
     
     // Send registration message
     char data[128];
-    snprintf(data, sizeof(data), "SERVICE_REGISTER:%s:%d", name, svc->id);
+    eclib_snprintf(data, sizeof(data), "SERVICE_REGISTER:%s:%d", name, svc->id);
     ipc_broadcast_msg(0x53455256, 0, strlen(data), data);  // "SERV"
     
     return svc->id;
@@ -52,12 +61,13 @@ int service_unregister(int service_id) {
         if (g_registry.services[i].id == service_id) {
             // Send unregistration message
             char data[128];
-            snprintf(data, sizeof(data), "SERVICE_UNREGISTER:%d", service_id);
+            eclib_snprintf(data, sizeof(data), "SERVICE_UNREGISTER:%d", service_id);
             ipc_broadcast_msg(0x53455256, 0, strlen(data), data);
             
             // Remove
             for (int j = i; j < g_registry.count - 1; j++) {
                 g_registry.services[j] = g_registry.services[j + 1];
+                g_registry.atoms[j] = g_registry.atoms[j + 1];
             }
             g_registry.count--;
             return 0;
@@ -74,4 +84,22 @@ int service_heartbeat(int service_id) {
         }
     }
     return -1;
+}
+
+int service_find_by_name(const char* name, struct service_info* info) {
+    if (!name) {
+        return -1;
+    }
+    // A name never interned was never registered either
+    eclib_atom_t atom = eclib_atom_find(name);
+    if (atom == ECLIB_ATOM_NONE) {
+        return -1;
+    }
+    for (int i = 0; i < g_registry.count; i++) {
+        if (g_registry.atoms[i] == atom) {
+            if (info) *info = g_registry.services[i];
+            return 0;
+        }
+    }
+    return -1;
 }
\ No newline at end of file
@@ -1,10 +1,10 @@
 #include "eclib/shutdown.h"
 #include "eclib/ipc_message.h"
 #include "eclib/capability.h"
+#include "eclib/utils.h"
 #include <string.h>
 #include <unistd.h>
 #include <sys/syscall.h>
-#include <stdio.h> // Added for snprintf
 
 #define SYS_SHUTDOWN          2001
 #define SYS_REBOOT            2002
@@ -29,15 +29,15 @@ int shutdown_system(enum shutdown_reason reason, uint32_t flags,
     // 构建关机消息
     char msg_buf[256];
     if (message && strlen(message) > 0) {
-        snprintf(msg_buf, sizeof(msg_buf), "%s", message);
+        eclib_snprintf(msg_buf, sizeof(msg_buf), "%s", message);
     } else {
-        snprintf(msg_buf, sizeof(msg_buf), "用户请求关机");
+        eclib_snprintf(msg_buf, sizeof(msg_buf), "用户请求关机");
     }
     
     // 发送IPC广播通知所有进程
     if (!(flags & SHUTDOWN_FLAG_NOWAIT)) {
         char ipc_msg[512];
-        snprintf(ipc_msg, sizeof(ipc_msg), 
+        eclib_snprintf(ipc_msg, sizeof(ipc_msg), 
                  "SHUTDOWN:reason=%d:message=%s", reason, msg_buf);
         ipc_broadcast_msg(IPC_MSG_SHUTDOWN_REQUEST, flags, 
                          strlen(ipc_msg), ipc_msg);
@@ -55,14 +55,14 @@ int reboot_system(enum shutdown_reason reason, uint32_t flags,
     
     char msg_buf[256];
     if (message && strlen(message) > 0) {
-        snprintf(msg_buf, sizeof(msg_buf), "%s", message);
+        eclib_snprintf(msg_buf, sizeof(msg_buf), "%s", message);
     } else {
-        snprintf(msg_buf, sizeof(msg_buf), "用户请求重启");
+        eclib_snprintf(msg_buf, sizeof(msg_buf), "用户请求重启");
     }
     
     if (!(flags & SHUTDOWN_FLAG_NOWAIT)) {
         char ipc_msg[512];
-        snprintf(ipc_msg, sizeof(ipc_msg), 
+        eclib_snprintf(ipc_msg, sizeof(ipc_msg), 
                  "REBOOT:reason=%d:message=%s", reason, msg_buf);
         ipc_broadcast_msg(IPC_MSG_SHUTDOWN_REQUEST, flags, 
                          strlen(ipc_msg), ipc_msg);
@@ -0,0 +1,364 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/sort.h"
+#include "eclib/men.h"
+#include "eclib/error.h"
+#include "eclib/utils.h"
+#include <pthread.h>
+
+// The callback sorts reuse the templates: elements of 4, 8 and 16 bytes
+// are sorted as such (byte-aligned structs, so any base address works),
+// anything else by sorting pointers to the elements and then moving each
+// element once along the cycles of the resulting permutation.
+
+typedef struct { uint32_t v; } __attribute__((packed, may_alias)) elem4_t;
+typedef struct { uint64_t v; } __attribute__((packed, may_alias)) elem8_t;
+typedef struct { uint64_t v[2]; } __attribute__((packed, may_alias)) elem16_t;
+typedef const char* elemp_t;
+
+// Comparator plus context; exactly one of cmp and cmp_r is set
+typedef struct {
+    eclib_cmp_fn cmp;
+    eclib_cmp_r_fn cmp_r;
+    void* ctx;
+} sort_cb_t;
+
+static inline int cb_less(const void* a, const void* b, void* ctx) {
+    const sort_cb_t* cb = ctx;
+    return (cb->cmp ? cb->cmp(a, b) : cb->cmp_r(a, b, cb->ctx)) < 0;
+}
+
+#define CB_LESS(x, y, ctx)      cb_less(x, y, ctx)
+#define CB_LESS_PTR(x, y, ctx)  cb_less(*(x), *(y), ctx)
+
+ECLIB_SORT_DEFINE_R(sort4, elem4_t, CB_LESS)
+ECLIB_SORT_DEFINE_R(sort8, elem8_t, CB_LESS)
+ECLIB_SORT_DEFINE_R(sort16, elem16_t, CB_LESS)
+ECLIB_SORT_DEFINE_R(sortp, elemp_t, CB_LESS_PTR)
+
+// Indirect sorts keep their pointer and index arrays on the stack up to this
+#define SORT_STACK_ELEMS    128
+
+static void swap_bytes(char* a, char* b, size_t size) {
+    while (size--) {
+        char t = *a;
+        *a++ = *b;
+        *b++ = t;
+    }
+}
+
+// Last resort when the indirect sort cannot get memory
+static void heap_bytes(char* base, size_t n, size_t size, sort_cb_t* cb) {
+    for (size_t start = n / 2, end = n; end > 1;) {
+        size_t i;
+        if (start > 0) {
+            i = --start;
+        } else {
+            end--;
+            swap_bytes(base, base + end * size, size);
+            i = 0;
+        }
+        for (;;) {
+            size_t c = 2 * i + 1;
+            if (c >= end) break;
+            if (c + 1 < end && cb_less(base + c * size, base + (c + 1) * size, cb)) c++;
+            if (!cb_less(base + i * size, base + c * size, cb)) break;
+            swap_bytes(base + i * size, base + c * size, size);
+            i = c;
+        }
+    }
+}
+
+static void sort_indirect(char* base, size_t n, size_t size, sort_cb_t* cb) {
+    elemp_t stack_ptrs[SORT_STACK_ELEMS];
+    size_t stack_dest[SORT_STACK_ELEMS];
+    elemp_t* ptrs = stack_ptrs;
+    size_t* dest = stack_dest;
+    void* mem = NULL;
+
+    if (n > SORT_STACK_ELEMS) {
+        mem = eclib_malloc(n * (sizeof(elemp_t) + sizeof(size_t)));
+        if (mem == NULL) {
+            heap_bytes(base, n, size, cb);
+            return;
+        }
+        ptrs = mem;
+        dest = (size_t*)(ptrs + n);
+    }
+
+    for (size_t i = 0; i < n; i++) ptrs[i] = base + i * size;
+    sortp_sort_r(ptrs, n, cb);
+
+    // The element now at ptrs[i] belongs at i; follow each cycle with swaps
+    for (size_t i = 0; i < n; i++) dest[(size_t)(ptrs[i] - base) / size] = i;
+    for (size_t i = 0; i < n; i++) {
+        while (dest[i] != i) {
+            size_t j = dest[i];
+            swap_bytes(base + i * size, base + j * size, size);
+            dest[i] = dest[j];
+            dest[j] = j;
+        }
+    }
+    eclib_free(mem);
+}
+
+static void sort_cb(void* base, size_t n, size_t size, sort_cb_t* cb) {
+    if (base == NULL || n < 2 || size == 0) return;
+    switch (size) {
+    case 4:  sort4_sort_r(base, n, cb); break;
+    case 8:  sort8_sort_r(base, n, cb); break;
+    case 16: sort16_sort_r(base, n, cb); break;
+    default: sort_indirect(base, n, size, cb); break;
+    }
+}
+
+void eclib_qsort(void* base, size_t n, size_t size, eclib_cmp_fn cmp) {
+    if (cmp == NULL) return;
+    sort_cb_t cb = { cmp, NULL, NULL };
+    sort_cb(base, n, size, &cb);
+}
+
+void eclib_qsort_r(void* base, size_t n, size_t size, eclib_cmp_r_fn cmp,
+                   void* ctx) {
+    if (cmp == NULL) return;
+    sort_cb_t cb = { NULL, cmp, ctx };
+    sort_cb(base, n, size, &cb);
+}
+
+// --------------------------
+// Search
+// --------------------------
+size_t eclib_lower_bound(const void* key, const void* base, size_t n,
+                         size_t size, eclib_cmp_fn cmp) {
+    if (base == NULL || n == 0 || cmp == NULL) return 0;
+    const char* b = base;
+    // Halve the range without branching on the comparison
+    while (n > 1) {
+        size_t half = n / 2;
+        b += cmp(b + half * size, key) < 0 ? half * size : 0;
+        n -= half;
+    }
+    return (size_t)(b - (const char*)base) / size + (cmp(b, key) < 0);
+}
+
+void* eclib_bsearch(const void* key, const void* base, size_t n, size_t size,
+                    eclib_cmp_fn cmp) {
+    if (base == NULL || cmp == NULL || size == 0) return NULL;
+    size_t i = eclib_lower_bound(key, base, n, size, cmp);
+    if (i == n) return NULL;
+    const char* at = (const char*)base + i * size;
+    return cmp(key, at) == 0 ? (void*)at : NULL;
+}
+
+// --------------------------
+// Radix
+// --------------------------
+#define U32_LESS(x, y)  (*(x) < *(y))
+#define U64_LESS(x, y)  (*(x) < *(y))
+ECLIB_SORT_DEFINE(sortu32, uint32_t, U32_LESS)
+ECLIB_SORT_DEFINE(sortu64, uint64_t, U64_LESS)
+
+// Below this many keys the counting passes cost more than they save
+#define RADIX_MIN       256
+
+#define RADIX_DEFINE(bits)                                                    \
+    eclib_err_t eclib_radix_sort_u##bits(uint##bits##_t* a, size_t n,         \
+                                         uint##bits##_t* tmp) {               \
+        if (a == NULL || n < 2) return ECLIB_OK;                              \
+        if (n < RADIX_MIN) {                                                  \
+            sortu##bits##_sort(a, n);                                         \
+            return ECLIB_OK;                                                  \
+        }                                                                     \
+        void* mem = NULL;                                                     \
+        if (tmp == NULL) {                                                    \
+            mem = tmp = eclib_malloc(n * sizeof(*a));                         \
+            if (tmp == NULL) {                                                \
+                eclib_set_last_err(ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY);       \
+                return ECLIB_ECLIB_CANNOT_ALLOCATE_MEMORY;                    \
+            }                                                                 \
+        }                                                                     \
+        enum { PASSES = bits / 8 };                                           \
+        size_t count[PASSES][256] = { { 0 } };                                \
+        for (size_t i = 0; i < n; i++) {                                      \
+            uint##bits##_t v = a[i];                                          \
+            for (int p = 0; p < PASSES; p++) count[p][(v >> (8 * p)) & 255]++; \
+        }                                                                     \
+        uint##bits##_t* src = a;                                              \
+        uint##bits##_t* dst = tmp;                                            \
+        for (int p = 0; p < PASSES; p++) {                                    \
+            size_t* c = count[p];                                             \
+            int shift = 8 * p;                                                \
+            if (c[(src[0] >> shift) & 255] == n) continue;                    \
+            size_t sum = 0;                                                   \
+            for (int d = 0; d < 256; d++) {                                   \
+                size_t k = c[d];                                              \
+                c[d] = sum;                                                   \
+                sum += k;                                                     \
+            }                                                                 \
+            for (size_t i = 0; i < n; i++) {                                  \
+                uint##bits##_t v = src[i];                                    \
+                dst[c[(v >> shift) & 255]++] = v;                             \
+            }                                                                 \
+            uint##bits##_t* t = src;                                          \
+            src = dst;                                                        \
+            dst = t;                                                          \
+        }                                                                     \
+        if (src != a) eclib_memcpy(a, src, n * sizeof(*a));                   \
+        eclib_free(mem);                                                      \
+        return ECLIB_OK;                                                      \
+    }
+
+RADIX_DEFINE(32)
+RADIX_DEFINE(64)
+
+// --------------------------
+// Parallel merge sort
+// --------------------------
+#define PAR_MIN_ELEMS   (64 * 1024)     // below this one thread is faster
+#define PAR_MIN_RUN     (8 * 1024)      // smallest run worth a thread
+#define PAR_MAX_THREADS 64
+
+typedef struct {
+    char* src;
+    char* dst;
+    size_t n;
+    size_t size;
+    eclib_cmp_fn cmp;
+    size_t bounds[PAR_MAX_THREADS + 1];  // run i is [bounds[i], bounds[i + 1])
+    unsigned runs;
+    unsigned width;                     // runs per half of a merge
+} par_sort_t;
+
+typedef struct {
+    par_sort_t* job;
+    unsigned id;
+} par_worker_t;
+
+static inline void copy_elem(char* dst, const char* src, size_t size) {
+    switch (size) {
+    case 4:  *(elem4_t*)dst = *(const elem4_t*)src; break;
+    case 8:  *(elem8_t*)dst = *(const elem8_t*)src; break;
+    default: eclib_memcpy(dst, src, size); break;
+    }
+}
+
+// Split point of the merge of a[0..na) and b[0..nb): how many of the first
+// k outputs come from a. Ties go to a.
+static size_t co_rank(const char* a, size_t na, const char* b, size_t nb,
+                      size_t k, size_t size, eclib_cmp_fn cmp) {
+    size_t lo = k > nb ? k - nb : 0;
+    size_t hi = k < na ? k : na;
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+        if (cmp(a + i * size, b + (j - 1) * size) <= 0) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+static void* par_sort_run(void* arg) {
+    par_worker_t* w = arg;
+    par_sort_t* job = w->job;
+    size_t lo = job->bounds[w->id], hi = job->bounds[w->id + 1];
+    eclib_qsort(job->src + lo * job->size, hi - lo, job->size, job->cmp);
+    return NULL;
+}
+
+// Each merge of two runs is shared by the 2 * width threads whose runs
+// it covers; this one writes its slice of the output
+static void* par_merge_slice(void* arg) {
+    par_worker_t* w = arg;
+    par_sort_t* job = w->job;
+    size_t size = job->size;
+    unsigned span = 2 * job->width;
+    unsigned first = w->id / span * span;
+    unsigned part = w->id % span;
+
+    size_t lo = job->bounds[first];
+    size_t mid = job->bounds[first + job->width];
+    size_t hi = job->bounds[first + span];
+    const char* a = job->src + lo * size;
+    const char* b = job->src + mid * size;
+    size_t na = mid - lo, nb = hi - mid, total = hi - lo;
+
+    size_t k0 = total * part / span, k1 = total * (part + 1) / span;
+    size_t i = co_rank(a, na, b, nb, k0, size, job->cmp);
+    size_t j = k0 - i;
+    char* out = job->dst + (lo + k0) * size;
+    for (size_t k = k0; k < k1; k++, out += size) {
+        if (j >= nb || (i < na && job->cmp(a + i * size, b + j * size) <= 0)) {
+            copy_elem(out, a + i++ * size, size);
+        } else {
+            copy_elem(out, b + j++ * size, size);
+        }
+    }
+    return NULL;
+}
+
+// Run fn on every worker, the caller doing worker 0 and the share of any
+// thread that fails to start
+static void par_run(par_worker_t* w, unsigned count, void* (*fn)(void*)) {
+    pthread_t tid[PAR_MAX_THREADS];
+    int started[PAR_MAX_THREADS] = { 0 };
+    for (unsigned t = 1; t < count; t++) {
+        started[t] = pthread_create(&tid[t], NULL, fn, &w[t]) == 0;
+        if (!started[t]) fn(&w[t]);
+    }
+    fn(&w[0]);
+    for (unsigned t = 1; t < count; t++) {
+        if (started[t]) pthread_join(tid[t], NULL);
+    }
+}
+
+void eclib_sort_parallel(void* base, size_t n, size_t size, eclib_cmp_fn cmp,
+                         unsigned threads) {
+    if (base == NULL || cmp == NULL || n < 2 || size == 0) return;
+
+    unsigned runs = 1;
+    while (runs * 2 <= threads && runs * 2 <= PAR_MAX_THREADS &&
+           n / (runs * 2) >= PAR_MIN_RUN) {
+        runs *= 2;
+    }
+    char* scratch = NULL;
+    if (runs > 1 && n >= PAR_MIN_ELEMS) scratch = eclib_malloc(n * size);
+    if (scratch == NULL) {
+        eclib_qsort(base, n, size, cmp);
+        return;
+    }
+
+    par_sort_t job;
+    job.src = base;
+    job.dst = scratch;
+    job.n = n;
+    job.size = size;
+    job.cmp = cmp;
+    job.runs = runs;
+    for (unsigned i = 0; i <= runs; i++) job.bounds[i] = n * i / runs;
+
+    par_worker_t w[PAR_MAX_THREADS];
+    for (unsigned i = 0; i < runs; i++) {
+        w[i].job = &job;
+        w[i].id = i;
+    }
+    par_run(w, runs, par_sort_run);
+    for (job.width = 1; job.width < runs; job.width *= 2) {
+        par_run(w, runs, par_merge_slice);
+        char* t = job.src;
+        job.src = job.dst;
+        job.dst = t;
+    }
+    if (job.src != base) eclib_memcpy(base, job.src, n * size);
+    eclib_free(scratch);
+}
@@ -23,6 +23,9 @@ void _start(void) {
     size_t bss_len = &__bss_end - &__bss_start;
     eclib_memset(&__bss_start, 0, bss_len);
 
+    // Switch the string/memory routines to the variants for this CPU
+    eclib_utils_init();
+
     // 2. Initialize the stack (if the microkernel has not set it, configure manually)
     // ARM architecture: Stack pointer (sp) points to the top of the stack (__stack_end)
     // Note: The stack grows downward, with the top being the high address
@@ -0,0 +1,173 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/utils.h"
+#include "utils_internal.h"
+#include "crc32c_table.h"
+
+// CRC-32C
+// -------
+// The variants work on the raw register (no pre/post inversion). The
+// portable one is slice-by-8: eight table lookups per 8 bytes. The
+// hardware ones (SSE4.2 crc32, ARMv8 CRC32CX) would be limited by the
+// latency of the instruction on one chain, so big buffers are cut into
+// three equal blocks that are run at the same time, and the three results
+// joined by advancing each over the length of the blocks after it with
+// the zero-byte tables.
+
+#define CRC32C_POLY     0x82F63B78u
+
+static inline uint32_t load32_le(const uint8_t* p) {
+    uint32_t v = *(const utils_u32*)p;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+static inline uint64_t load64_le(const uint8_t* p) {
+    uint64_t v = *(const utils_u64*)p;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+uint32_t utils_crc32c_generic(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* p = data;
+    const uint32_t (*t)[256] = CRC32C_SLICE;
+
+    while (len && ((uintptr_t)p & 7)) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+        len--;
+    }
+    for (; len >= 8; len -= 8, p += 8) {
+        uint32_t lo = crc ^ load32_le(p);
+        uint32_t hi = load32_le(p + 4);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+              t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+// Advance a register over one block of zero bytes
+static inline uint32_t crc_shift(const uint32_t (*z)[256], uint32_t crc) {
+    return z[0][crc & 0xFF] ^ z[1][(crc >> 8) & 0xFF] ^
+           z[2][(crc >> 16) & 0xFF] ^ z[3][crc >> 24];
+}
+
+// Three-stream body shared by the hardware variants; U64(crc, v) and
+// U8(crc, b) are the instructions
+#define CRC32C_HW_BODY(U64, U8)                                               \
+    const uint8_t* p = data;                                                  \
+    uint64_t c0 = crc;                                                        \
+    while (len >= 3 * CRC32C_LONG_LEN) {                                      \
+        uint64_t c1 = 0, c2 = 0;                                              \
+        const uint8_t* end = p + CRC32C_LONG_LEN;                             \
+        do {                                                                  \
+            c0 = U64(c0, load64_le(p));                                       \
+            c1 = U64(c1, load64_le(p + CRC32C_LONG_LEN));                     \
+            c2 = U64(c2, load64_le(p + 2 * CRC32C_LONG_LEN));                 \
+            p += 8;                                                           \
+        } while (p < end);                                                    \
+        c0 = crc_shift(CRC32C_LONG, (uint32_t)c0) ^ c1;                       \
+        c0 = crc_shift(CRC32C_LONG, (uint32_t)c0) ^ c2;                       \
+        p += 2 * CRC32C_LONG_LEN;                                             \
+        len -= 3 * CRC32C_LONG_LEN;                                           \
+    }                                                                         \
+    while (len >= 3 * CRC32C_SHORT_LEN) {                                     \
+        uint64_t c1 = 0, c2 = 0;                                              \
+        const uint8_t* end = p + CRC32C_SHORT_LEN;                            \
+        do {                                                                  \
+            c0 = U64(c0, load64_le(p));                                       \
+            c1 = U64(c1, load64_le(p + CRC32C_SHORT_LEN));                    \
+            c2 = U64(c2, load64_le(p + 2 * CRC32C_SHORT_LEN));                \
+            p += 8;                                                           \
+        } while (p < end);                                                    \
+        c0 = crc_shift(CRC32C_SHORT, (uint32_t)c0) ^ c1;                      \
+        c0 = crc_shift(CRC32C_SHORT, (uint32_t)c0) ^ c2;                      \
+        p += 2 * CRC32C_SHORT_LEN;                                            \
+        len -= 3 * CRC32C_SHORT_LEN;                                          \
+    }                                                                         \
+    for (; len >= 8; len -= 8, p += 8) c0 = U64(c0, load64_le(p));            \
+    while (len--) c0 = U8((uint32_t)c0, *p++);                                \
+    return (uint32_t)c0;
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+uint32_t utils_crc32c_sse42(uint32_t crc, const void* data, size_t len) {
+    CRC32C_HW_BODY(_mm_crc32_u64, _mm_crc32_u8)
+}
+#pragma GCC pop_options
+
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+
+#pragma GCC push_options
+#pragma GCC target("+crc")
+uint32_t utils_crc32c_armv8(uint32_t crc, const void* data, size_t len) {
+    CRC32C_HW_BODY(__crc32cd, __crc32cb)
+}
+#pragma GCC pop_options
+
+#endif
+
+uint32_t eclib_crc32c(uint32_t crc, const void* data, size_t len) {
+    if (data == NULL || len == 0) return crc;
+    return ~g_utils_ops.crc32c(~crc, data, len);
+}
+
+// --------------------------
+// Combine
+// --------------------------
+// Appending len zero bytes is linear over GF(2): a 32x32 bit matrix,
+// squared repeatedly to cover len in O(log len) steps (as zlib does).
+static uint32_t gf2_times(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    for (; vec; vec >>= 1, mat++) {
+        if (vec & 1) sum ^= *mat;
+    }
+    return sum;
+}
+
+static void gf2_square(uint32_t* square, const uint32_t* mat) {
+    for (int n = 0; n < 32; n++) square[n] = gf2_times(mat, mat[n]);
+}
+
+uint32_t eclib_crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2) {
+    if (len2 == 0) return crc1;
+
+    uint32_t even[32], odd[32];
+    // Operator for one zero bit, then two, then four
+    odd[0] = CRC32C_POLY;
+    for (int n = 1; n < 32; n++) odd[n] = 1u << (n - 1);
+    gf2_square(even, odd);
+    gf2_square(odd, even);
+
+    // Square up through the bits of len2 (in bytes: eight zero bits first)
+    do {
+        gf2_square(even, odd);
+        if (len2 & 1) crc1 = gf2_times(even, crc1);
+        len2 >>= 1;
+        if (len2 == 0) break;
+        gf2_square(odd, even);
+        if (len2 & 1) crc1 = gf2_times(odd, crc1);
+        len2 >>= 1;
+    } while (len2);
+    return crc1 ^ crc2;
+}
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+#
+# ECLib - E-comOS C Library
+# Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+#
+# This file is part of ECLib.
+# ECLib is free library; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+#
+# Writes crc32c_table.h:  python3 crc32c_table.py > crc32c_table.h
+# The block lengths must match the ones crc32c.c cuts buffers into.
+
+POLY = 0x82F63B78
+LONG_LEN = 8192
+SHORT_LEN = 256
+
+HEADER = """\
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+// Tables for crc32c.c (CRC-32C, reflected polynomial 0x82F63B78).
+//   CRC32C_SLICE[k][b]   register after byte b followed by k zero bytes
+//   CRC32C_LONG/SHORT    advance a register over CRC32C_LONG_LEN /
+//                        CRC32C_SHORT_LEN zero bytes, one table per byte
+//                        of the register; the results are XORed
+// Generated by crc32c_table.py; do not edit by hand.
+#ifndef ECLIB_CRC32C_TABLE_H
+#define ECLIB_CRC32C_TABLE_H
+#include <stdint.h>
+"""
+
+
+def zero_bits(crc, n):
+    """Register after n zero bits"""
+    for _ in range(n):
+        crc = (crc >> 1) ^ (POLY if crc & 1 else 0)
+    return crc
+
+
+def slice_tables():
+    t = [[zero_bits(b, 8) for b in range(256)]]
+    for k in range(1, 8):
+        t.append([(v >> 8) ^ t[0][v & 0xFF] for v in t[k - 1]])
+    return t
+
+
+def shift_tables(nbytes):
+    # Zero bytes act linearly on the register: advance each bit once and
+    # build every byte value from those
+    basis = [zero_bits(1 << i, 8 * nbytes) for i in range(32)]
+    tables = []
+    for j in range(4):
+        row = []
+        for b in range(256):
+            v = 0
+            for i in range(8):
+                if b >> i & 1:
+                    v ^= basis[8 * j + i]
+            row.append(v)
+        tables.append(row)
+    return tables
+
+
+def emit(name, tables):
+    out = ["static const uint32_t %s[%d][256] = {" % (name, len(tables))]
+    for t in tables:
+        out.append("    {")
+        for i in range(0, 256, 6):
+            out.append("        " +
+                       " ".join("0x%08x," % v for v in t[i:i + 6]))
+        out.append("    },")
+    out.append("};")
+    return "\n".join(out)
+
+
+def main():
+    print(HEADER)
+    print("#define CRC32C_LONG_LEN     %d" % LONG_LEN)
+    print("#define CRC32C_SHORT_LEN    %d" % SHORT_LEN)
+    print()
+    print(emit("CRC32C_SLICE", slice_tables()))
+    print()
+    print(emit("CRC32C_LONG", shift_tables(LONG_LEN)))
+    print()
+    print(emit("CRC32C_SHORT", shift_tables(SHORT_LEN)))
+    print()
+    print("#endif // ECLIB_CRC32C_TABLE_H")
+
+
+if __name__ == "__main__":
+    main()
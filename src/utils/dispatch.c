@@ -0,0 +1,140 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/utils.h"
+#include "utils_internal.h"
+#if defined(__x86_64__)
+#include <cpuid.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+#define UTILS_OPS_OF(sfx)                       \
+    .memcpy = utils_memcpy_##sfx,               \
+    .memmove = utils_memmove_##sfx,             \
+    .memset = utils_memset_##sfx,               \
+    .strlen = utils_strlen_##sfx,               \
+    .strnlen = utils_strnlen_##sfx,             \
+    .strchr = utils_strchr_##sfx,               \
+    .strrchr = utils_strrchr_##sfx,             \
+    .strcmp = utils_strcmp_##sfx,               \
+    .strncmp = utils_strncmp_##sfx,             \
+    .memchr = utils_memchr_##sfx,               \
+    .memrchr = utils_memrchr_##sfx,             \
+    .memcmp = utils_memcmp_##sfx
+
+#define UTILS_USE(sfx) do {                             \
+        g_utils_ops.memcpy = utils_memcpy_##sfx;        \
+        g_utils_ops.memmove = utils_memmove_##sfx;      \
+        g_utils_ops.memset = utils_memset_##sfx;        \
+        g_utils_ops.strlen = utils_strlen_##sfx;        \
+        g_utils_ops.strnlen = utils_strnlen_##sfx;      \
+        g_utils_ops.strchr = utils_strchr_##sfx;        \
+        g_utils_ops.strrchr = utils_strrchr_##sfx;      \
+        g_utils_ops.strcmp = utils_strcmp_##sfx;        \
+        g_utils_ops.strncmp = utils_strncmp_##sfx;      \
+        g_utils_ops.memchr = utils_memchr_##sfx;        \
+        g_utils_ops.memrchr = utils_memrchr_##sfx;      \
+        g_utils_ops.memcmp = utils_memcmp_##sfx;        \
+    } while (0)
+
+// Lives in .data with the portable versions, so it is usable before
+// anything ran -- in particular by the BSS clear in _start.
+utils_ops_t g_utils_ops = {
+    UTILS_OPS_OF(generic),
+    .setspn = utils_setspn_generic,
+    .setspn_mem = utils_setspn_mem_generic,
+    .crc32c = utils_crc32c_generic,
+    .utf8_check = utils_utf8_check_generic,
+    .nt_threshold = UTILS_NT_DEFAULT,
+    .cpu = 0,
+};
+
+#if defined(__x86_64__)
+static uint32_t cpu_detect(void) {
+    uint32_t a, b, c, d;
+    uint32_t cpu = UTILS_CPU_SSE2;
+
+    if (!__get_cpuid(1, &a, &b, &c, &d)) return cpu;
+    if (c & bit_SSE4_2) cpu |= UTILS_CPU_SSE42;
+    // AVX2 needs the CPU bit and the OS saving the upper YMM halves
+    if ((c & bit_OSXSAVE) && (c & bit_AVX)) {
+        uint32_t xcr0_lo, xcr0_hi;
+        __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+        if ((xcr0_lo & 0x6) == 0x6 &&
+            __get_cpuid_count(7, 0, &a, &b, &c, &d) && (b & bit_AVX2)) {
+            cpu |= UTILS_CPU_AVX2;
+        }
+    }
+    return cpu;
+}
+
+// Size of the last-level cache from the deterministic cache parameters
+// leaf; 0 if the CPU does not report it that way.
+static size_t cpu_llc_size(void) {
+    uint32_t a, b, c, d;
+    size_t size = 0;
+
+    if (__get_cpuid_max(0, NULL) < 4) return 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        __cpuid_count(4, i, a, b, c, d);
+        if ((a & 0x1F) == 0) break;             // no more caches
+        size_t ways = (b >> 22) + 1;
+        size_t parts = ((b >> 12) & 0x3FF) + 1;
+        size_t line = (b & 0xFFF) + 1;
+        size_t sets = (size_t)c + 1;
+        if (ways * parts * line * sets > size) {
+            size = ways * parts * line * sets;
+        }
+    }
+    return size;
+}
+#endif
+
+void eclib_utils_init(void) {
+#if defined(__x86_64__)
+    uint32_t cpu = cpu_detect();
+    size_t llc = cpu_llc_size();
+
+    if (llc) g_utils_ops.nt_threshold = llc / 4 * 3;
+    if (cpu & UTILS_CPU_AVX2) {
+        UTILS_USE(avx2);
+        g_utils_ops.setspn = utils_setspn_avx2;
+        g_utils_ops.setspn_mem = utils_setspn_mem_avx2;
+        g_utils_ops.utf8_check = utils_utf8_check_avx2;
+    } else {
+        UTILS_USE(sse2);
+    }
+    if (cpu & UTILS_CPU_SSE42) g_utils_ops.crc32c = utils_crc32c_sse42;
+    g_utils_ops.cpu = cpu;
+#elif defined(__aarch64__)
+    UTILS_USE(neon);
+    g_utils_ops.setspn = utils_setspn_neon;
+    g_utils_ops.setspn_mem = utils_setspn_mem_neon;
+    g_utils_ops.utf8_check = utils_utf8_check_neon;
+    g_utils_ops.cpu = UTILS_CPU_NEON;
+    // CRC32 is optional before ARMv8.1
+#if defined(__ARM_FEATURE_CRC32)
+    g_utils_ops.cpu |= UTILS_CPU_CRC32;
+#elif defined(__linux__)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) g_utils_ops.cpu |= UTILS_CPU_CRC32;
+#endif
+    if (g_utils_ops.cpu & UTILS_CPU_CRC32) {
+        g_utils_ops.crc32c = utils_crc32c_armv8;
+    }
+#endif
+}
+
+// _start calls eclib_utils_init itself; this covers programs that enter
+// through a host C runtime instead.
+__attribute__((constructor))
+static void utils_ctor(void) {
+    eclib_utils_init();
+}
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+#
+# ECLib - E-comOS C Library
+# Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+#
+# This file is part of ECLib.
+# ECLib is free library; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+#
+# Writes dtoa_table.h:  python3 dtoa_table.py > dtoa_table.h
+# The counts are Ryu's table sizes for doubles: every q and i that
+# format.c can index with.
+
+POW5_BITS = 125
+POW5_INV_BITS = 125
+POW5_COUNT = 326
+POW5_INV_COUNT = 342
+
+HEADER = """\
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+// Powers of five for the shortest double formatting in format.c, as
+// {low 64 bits, high 64 bits}. With b(i) the bit length of 5^i:
+//   DTOA_POW5[i]     = 5^i scaled to exactly 125 bits (truncated)
+//   DTOA_POW5_INV[i] = floor(2^(b(i) - 1 + 125) / 5^i) + 1
+// Generated by dtoa_table.py; do not edit by hand.
+#ifndef ECLIB_DTOA_TABLE_H
+#define ECLIB_DTOA_TABLE_H
+#include <stdint.h>
+"""
+
+MASK64 = (1 << 64) - 1
+
+
+def pow5(i):
+    p = 5 ** i
+    shift = p.bit_length() - POW5_BITS
+    return p >> shift if shift >= 0 else p << -shift
+
+
+def pow5_inv(i):
+    p = 5 ** i
+    return (1 << (p.bit_length() - 1 + POW5_INV_BITS)) // p + 1
+
+
+def emit(name, count, values):
+    out = ["static const uint64_t %s[%s][2] = {" % (name, count)]
+    for v in values:
+        out.append("    { 0x%016xull, 0x%016xull }," % (v & MASK64, v >> 64))
+    out.append("};")
+    return "\n".join(out)
+
+
+def main():
+    print(HEADER)
+    print("#define DTOA_POW5_BITS          %d" % POW5_BITS)
+    print("#define DTOA_POW5_INV_BITS      %d" % POW5_INV_BITS)
+    print()
+    print("#define DTOA_POW5_COUNT         %d" % POW5_COUNT)
+    print("#define DTOA_POW5_INV_COUNT     %d" % POW5_INV_COUNT)
+    print()
+    print(emit("DTOA_POW5", "DTOA_POW5_COUNT",
+               [pow5(i) for i in range(POW5_COUNT)]))
+    print()
+    print(emit("DTOA_POW5_INV", "DTOA_POW5_INV_COUNT",
+               [pow5_inv(i) for i in range(POW5_INV_COUNT)]))
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
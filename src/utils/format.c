@@ -0,0 +1,1019 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/utils.h"
+#include "utils_internal.h"
+#include "dtoa_table.h"
+#include <limits.h>
+
+// Formatted output
+// ----------------
+// Everything goes through fmt_out_t: for snprintf a window onto the
+// caller's buffer, for the sink API a small stack buffer handed to the
+// sink whenever it fills. Conversions write their digits into a scratch
+// area sized for the worst case and are copied out once, padding
+// included, so no output is ever built twice.
+
+#define FMT_LEFT        0x01    // '-'
+#define FMT_PLUS        0x02    // '+'
+#define FMT_SPACE       0x04    // ' '
+#define FMT_ALT         0x08    // '#'
+#define FMT_ZERO        0x10    // '0'
+
+#define FMT_SINK_BUF    256
+// Digits of the longest %f output that is not just zeros: 309 integer
+// digits for DBL_MAX, 1074 fraction digits for the smallest subnormal.
+#define FMT_FLOAT_BUF   1408
+
+enum { LEN_INT, LEN_CHAR, LEN_SHORT, LEN_LONG, LEN_LLONG, LEN_SIZE,
+       LEN_MAX, LEN_PTRDIFF, LEN_LDOUBLE };
+
+typedef struct {
+    char* buf;
+    size_t cap;             // usable bytes of buf
+    size_t len;             // bytes in buf
+    size_t total;           // bytes produced, dropped ones included
+    eclib_sink_fn sink;     // NULL: drop what does not fit
+    void* ctx;
+} fmt_out_t;
+
+typedef struct {
+    unsigned flags;
+    size_t width;
+    int prec;               // -1 if not given
+} fmt_spec_t;
+
+static const char DIGITS2[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char XDIGITS[2][16] = {
+    { '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f' },
+    { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F' },
+};
+
+// --------------------------
+// Output
+// --------------------------
+static void out_flush(fmt_out_t* o) {
+    if (o->len) o->sink(o->ctx, o->buf, o->len);
+    o->len = 0;
+}
+
+static void out_write(fmt_out_t* o, const char* s, size_t n) {
+    o->total += n;
+    size_t room = o->cap - o->len;
+    if (n <= room) {
+        if (n <= 16) {
+            for (size_t i = 0; i < n; i++) o->buf[o->len + i] = s[i];
+        } else {
+            eclib_memcpy(o->buf + o->len, s, n);
+        }
+        o->len += n;
+        return;
+    }
+    if (o->sink == NULL) {
+        eclib_memcpy(o->buf + o->len, s, room);
+        o->len = o->cap;
+        return;
+    }
+    // Too big for what is left: pass it through rather than chunking it
+    out_flush(o);
+    if (n >= o->cap) {
+        o->sink(o->ctx, s, n);
+    } else {
+        eclib_memcpy(o->buf, s, n);
+        o->len = n;
+    }
+}
+
+static void out_fill(fmt_out_t* o, char c, size_t n) {
+    o->total += n;
+    while (n) {
+        size_t room = o->cap - o->len;
+        size_t k = n < room ? n : room;
+        eclib_memset(o->buf + o->len, c, k);
+        o->len += k;
+        n -= k;
+        if (n == 0) break;
+        if (o->sink == NULL) return;
+        out_flush(o);
+    }
+}
+
+// prefix, zeros, body, zeros, suffix -- padded to the field width
+static void out_field_sfx(fmt_out_t* o, const fmt_spec_t* sp,
+                          const char* prefix, size_t plen, size_t zeros,
+                          const char* body, size_t blen, size_t trail,
+                          const char* sfx, size_t slen) {
+    size_t len = plen + zeros + blen + trail + slen;
+    size_t pad = sp->width > len ? sp->width - len : 0;
+
+    if (pad && (sp->flags & (FMT_ZERO | FMT_LEFT)) == FMT_ZERO) {
+        zeros += pad;
+        pad = 0;
+    }
+    if (pad && !(sp->flags & FMT_LEFT)) out_fill(o, ' ', pad);
+    if (plen) out_write(o, prefix, plen);
+    if (zeros) out_fill(o, '0', zeros);
+    out_write(o, body, blen);
+    if (trail) out_fill(o, '0', trail);
+    if (slen) out_write(o, sfx, slen);
+    if (pad && (sp->flags & FMT_LEFT)) out_fill(o, ' ', pad);
+}
+
+static void out_field(fmt_out_t* o, const fmt_spec_t* sp,
+                      const char* prefix, size_t plen, size_t zeros,
+                      const char* body, size_t blen, size_t trail) {
+    out_field_sfx(o, sp, prefix, plen, zeros, body, blen, trail, NULL, 0);
+}
+
+// --------------------------
+// Integers
+// --------------------------
+// Digits are written backwards, ending at end; the start is returned.
+static char* fmt_dec(char* end, uint64_t v) {
+    while (v >= 100) {
+        const char* d = DIGITS2 + (v % 100) * 2;
+        v /= 100;
+        end -= 2;
+        end[0] = d[0];
+        end[1] = d[1];
+    }
+    if (v >= 10) {
+        end -= 2;
+        end[0] = DIGITS2[v * 2];
+        end[1] = DIGITS2[v * 2 + 1];
+    } else {
+        *--end = (char)('0' + v);
+    }
+    return end;
+}
+
+static char* fmt_hex(char* end, uint64_t v, int upper) {
+    do {
+        *--end = XDIGITS[upper][v & 0xF];
+        v >>= 4;
+    } while (v);
+    return end;
+}
+
+static char* fmt_oct(char* end, uint64_t v) {
+    do {
+        *--end = (char)('0' + (v & 7));
+        v >>= 3;
+    } while (v);
+    return end;
+}
+
+static void fmt_int(fmt_out_t* o, fmt_spec_t* sp, uint64_t v, int neg,
+                    char conv) {
+    char tmp[24];
+    char* end = tmp + sizeof(tmp);
+    char* p;
+    char prefix[2];
+    size_t plen = 0;
+
+    if (conv == 'x' || conv == 'X') {
+        p = fmt_hex(end, v, conv == 'X');
+        if ((sp->flags & FMT_ALT) && v) {
+            prefix[plen++] = '0';
+            prefix[plen++] = conv;
+        }
+    } else if (conv == 'o') {
+        p = fmt_oct(end, v);
+    } else {
+        p = fmt_dec(end, v);
+        if (neg) prefix[plen++] = '-';
+        else if (sp->flags & FMT_PLUS) prefix[plen++] = '+';
+        else if (sp->flags & FMT_SPACE) prefix[plen++] = ' ';
+    }
+
+    size_t n = (size_t)(end - p);
+    size_t zeros = 0;
+    if (sp->prec >= 0) {
+        sp->flags &= ~FMT_ZERO;
+        if (sp->prec == 0 && v == 0) n = 0;            // "%.0d" of 0 is empty
+        if ((size_t)sp->prec > n) zeros = (size_t)sp->prec - n;
+    }
+    if (conv == 'o' && (sp->flags & FMT_ALT) && zeros == 0 &&
+        (n == 0 || *p != '0')) {
+        zeros = 1;
+    }
+    out_field(o, sp, prefix, plen, zeros, end - n, n, 0);
+}
+
+// --------------------------
+// Shortest doubles (Ryu)
+// --------------------------
+// Finds the shortest decimal in the rounding interval of a double with
+// 128-bit multiplies against DTOA_POW5 / DTOA_POW5_INV, so the digits
+// read back as the same double and no bignum is needed.
+
+static inline uint32_t pow5_bits(int32_t e) {
+    return (uint32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+static inline uint32_t log10_pow2(int32_t e) {
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+static inline uint32_t log10_pow5(int32_t e) {
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+static inline int pow5_multiple(uint64_t v, uint32_t p) {
+    uint32_t count = 0;
+    while (v % 5 == 0) {
+        v /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+static inline int pow2_multiple(uint64_t v, uint32_t p) {
+    return (v & ((1ull << p) - 1)) == 0;
+}
+
+static inline uint64_t mul_shift64(uint64_t m, const uint64_t* mul, int32_t j) {
+    unsigned __int128 lo = (unsigned __int128)m * mul[0];
+    unsigned __int128 hi = (unsigned __int128)m * mul[1];
+    return (uint64_t)(((lo >> 64) + hi) >> (j - 64));
+}
+
+// Shortest m10 * 10^e10 for the finite, non-zero double with the given
+// mantissa and biased exponent fields.
+static uint64_t dtoa_shortest(uint64_t frac, uint32_t bexp, int32_t* e10_out) {
+    int32_t e2;
+    uint64_t m2;
+    if (bexp == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = frac;
+    } else {
+        e2 = (int32_t)bexp - 1023 - 52 - 2;
+        m2 = (1ull << 52) | frac;
+    }
+    int even = (m2 & 1) == 0;
+
+    // The interval of decimals that round to this double, times 4
+    uint64_t mv = 4 * m2;
+    uint32_t mm_shift = frac != 0 || bexp <= 1;
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    int vm_zeros = 0, vr_zeros = 0;
+
+    if (e2 >= 0) {
+        uint32_t q = log10_pow2(e2) - (e2 > 3);
+        int32_t k = DTOA_POW5_INV_BITS + (int32_t)pow5_bits((int32_t)q) - 1;
+        int32_t i = -e2 + (int32_t)q + k;
+        e10 = (int32_t)q;
+        vr = mul_shift64(4 * m2, DTOA_POW5_INV[q], i);
+        vp = mul_shift64(4 * m2 + 2, DTOA_POW5_INV[q], i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, DTOA_POW5_INV[q], i);
+        if (q <= 21) {
+            if (mv % 5 == 0) {
+                vr_zeros = pow5_multiple(mv, q);
+            } else if (even) {
+                vm_zeros = pow5_multiple(mv - 1 - mm_shift, q);
+            } else {
+                vp -= pow5_multiple(mv + 2, q);
+            }
+        }
+    } else {
+        uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+        int32_t i = -e2 - (int32_t)q;
+        int32_t k = (int32_t)pow5_bits(i) - DTOA_POW5_BITS;
+        int32_t j = (int32_t)q - k;
+        e10 = (int32_t)q + e2;
+        vr = mul_shift64(4 * m2, DTOA_POW5[i], j);
+        vp = mul_shift64(4 * m2 + 2, DTOA_POW5[i], j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, DTOA_POW5[i], j);
+        if (q <= 1) {
+            vr_zeros = 1;
+            if (even) vm_zeros = mm_shift == 1;
+            else vp--;
+        } else if (q < 63) {
+            vr_zeros = pow2_multiple(mv, q);
+        }
+    }
+
+    // Drop digits while the interval still holds more than one candidate
+    int32_t removed = 0;
+    uint32_t last = 0;
+    uint64_t out;
+    if (vm_zeros || vr_zeros) {
+        while (vp / 10 > vm / 10) {
+            vm_zeros &= vm % 10 == 0;
+            vr_zeros &= last == 0;
+            last = (uint32_t)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_zeros) {
+            while (vm % 10 == 0) {
+                vr_zeros &= last == 0;
+                last = (uint32_t)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_zeros && last == 5 && vr % 2 == 0) last = 4;    // ties to even
+        out = vr + ((vr == vm && (!even || !vm_zeros)) || last >= 5);
+    } else {
+        int up = 0;
+        if (vp / 100 > vm / 100) {
+            up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        out = vr + (vr == vm || up);
+    }
+    *e10_out = e10 + removed;
+    return out;
+}
+
+// Shortest round-trip digits of a positive finite double in plain
+// decimal notation. *trail gets the zeros that belong after them.
+static size_t fmt_shortest(uint64_t bits, char* out, size_t* trail) {
+    uint64_t frac = bits & ((1ull << 52) - 1);
+    uint32_t bexp = (uint32_t)(bits >> 52) & 0x7FF;
+    char tmp[24];
+    char* end = tmp + sizeof(tmp);
+    char* p;
+    int32_t e10 = 0;
+
+    *trail = 0;
+    if ((bits << 1) == 0) {
+        out[0] = '0';
+        return 1;
+    }
+
+    // Integers below 2^53 are exact and already as short as they get
+    int32_t e2 = (int32_t)bexp - 1023 - 52;
+    uint64_t m2 = (1ull << 52) | frac;
+    if (bexp && e2 <= 0 && e2 >= -52 && (m2 & ((1ull << -e2) - 1)) == 0) {
+        p = fmt_dec(end, m2 >> -e2);
+    } else {
+        p = fmt_dec(end, dtoa_shortest(frac, bexp, &e10));
+    }
+    size_t n = (size_t)(end - p);
+
+    if (e10 >= 0) {
+        eclib_memcpy(out, p, n);
+        *trail = (size_t)e10;
+        return n;
+    }
+    size_t point = (size_t)-e10;
+    if (n > point) {
+        size_t ip = n - point;
+        eclib_memcpy(out, p, ip);
+        out[ip] = '.';
+        eclib_memcpy(out + ip + 1, p + ip, point);
+        return n + 1;
+    }
+    size_t lead = point - n;
+    out[0] = '0';
+    out[1] = '.';
+    eclib_memset(out + 2, '0', lead);
+    eclib_memcpy(out + 2 + lead, p, n);
+    return 2 + lead + n;
+}
+
+// --------------------------
+// Fixed precision doubles
+// --------------------------
+// Exact: the binary value m * 2^e is expanded digit by digit and rounded
+// half to even. 128-bit arithmetic covers everything with a 2^-124 or
+// coarser fraction and an integer part below 2^64; the rest (huge or tiny
+// magnitudes) uses 32-bit limbs.
+
+#define BIG_LIMBS       36      // 1024 + 53 + 31 bits
+
+// Decimal digits of m * 2^e, e > 11; returns their count
+static size_t big_int_digits(uint64_t m, int e, char* out) {
+    uint32_t limb[BIG_LIMBS] = { 0 };
+    size_t word = (size_t)e / 32, bit = (size_t)e % 32;
+    unsigned __int128 v = (unsigned __int128)m << bit;
+    size_t n = word;
+    while (v) {
+        limb[n++] = (uint32_t)v;
+        v >>= 32;
+    }
+
+    // Nine digits per division by 10^9, least significant chunk first
+    uint32_t chunk[40];
+    size_t chunks = 0;
+    while (n) {
+        uint64_t rem = 0;
+        for (size_t i = n; i-- > 0;) {
+            uint64_t cur = (rem << 32) | limb[i];
+            limb[i] = (uint32_t)(cur / 1000000000u);
+            rem = cur % 1000000000u;
+        }
+        chunk[chunks++] = (uint32_t)rem;
+        while (n && limb[n - 1] == 0) n--;
+    }
+
+    char tmp[12];
+    char* end = tmp + sizeof(tmp);
+    char* p = fmt_dec(end, chunk[--chunks]);
+    size_t len = (size_t)(end - p);
+    eclib_memcpy(out, p, len);
+    while (chunks) {
+        uint32_t c = chunk[--chunks];
+        for (int i = 8; i >= 0; i--) {
+            out[len + (size_t)i] = (char)('0' + c % 10);
+            c /= 10;
+        }
+        len += 9;
+    }
+    return len;
+}
+
+// Up to want fraction digits of m / 2^s, s > 124. Returns the count;
+// *sticky is set if anything non-zero follows them.
+static size_t big_frac_digits(uint64_t m, int s, char* out, size_t want,
+                              int* sticky) {
+    uint32_t limb[BIG_LIMBS] = { 0 };
+    size_t n = ((size_t)s + 31) / 32;
+    unsigned __int128 v = (unsigned __int128)m << (n * 32 - (size_t)s);
+    for (size_t i = 0; v; i++) {
+        limb[i] = (uint32_t)v;
+        v >>= 32;
+    }
+
+    size_t len = 0;
+    int nonzero = 1;
+    while (len < want && nonzero) {
+        uint64_t carry = 0;
+        nonzero = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t cur = (uint64_t)limb[i] * 1000000000u + carry;
+            limb[i] = (uint32_t)cur;
+            carry = cur >> 32;
+            nonzero |= limb[i] != 0;
+        }
+        uint32_t c = (uint32_t)carry;
+        for (int i = 8; i >= 0; i--) {
+            out[len + (size_t)i] = (char)('0' + c % 10);
+            c /= 10;
+        }
+        len += 9;
+    }
+    *sticky = nonzero;
+    if (len > want) {
+        for (size_t i = want; i < len; i++) *sticky |= out[i] != '0';
+        len = want;
+    }
+    return len;
+}
+
+// "int.frac" of a positive finite double with prec fraction digits.
+// *trail gets the zeros that belong after it.
+static size_t fmt_fixed(uint64_t bits, int prec, int alt, char* out,
+                        size_t* trail) {
+    uint64_t frac = bits & ((1ull << 52) - 1);
+    uint32_t bexp = (uint32_t)(bits >> 52) & 0x7FF;
+    uint64_t m = bexp ? (1ull << 52) | frac : frac;
+    int e = (bexp ? (int)bexp : 1) - 1023 - 52;
+
+    // Integer part, with one spare digit in front for a rounding carry
+    char* ip = out + 1;
+    size_t ilen;
+    int s = e < 0 ? -e : 0;
+    if (e > 11) {
+        ilen = big_int_digits(m, e, ip);
+    } else {
+        uint64_t iv = e >= 0 ? m << e : (s < 64 ? m >> s : 0);
+        char tmp[24];
+        char* end = tmp + sizeof(tmp);
+        char* p = fmt_dec(end, iv);
+        ilen = (size_t)(end - p);
+        eclib_memcpy(ip, p, ilen);
+    }
+
+    // Fraction digits, one more than needed for rounding
+    char* fp = ip + ilen + 1;
+    size_t want = (size_t)prec + 1;
+    size_t flen = 0;
+    int sticky = 0;
+    if (s > 124) {
+        flen = big_frac_digits(m, s, fp, want, &sticky);
+    } else if (s > 0) {
+        unsigned __int128 mask = ((unsigned __int128)1 << s) - 1;
+        unsigned __int128 f = (unsigned __int128)m & mask;
+        while (flen < want && f) {
+            f *= 10;
+            fp[flen++] = (char)('0' + (int)(f >> s));
+            f &= mask;
+        }
+        sticky = f != 0;
+    }
+
+    // Round half to even at prec digits
+    if (flen == want) {
+        char r = fp[--flen];
+        char prev = flen ? fp[flen - 1] : ip[ilen - 1];
+        if (r > '5' || (r == '5' && (sticky || (prev & 1)))) {
+            size_t i = flen;
+            while (i && fp[i - 1] == '9') fp[--i] = '0';
+            if (i) {
+                fp[i - 1]++;
+            } else {
+                i = ilen;
+                while (i && ip[i - 1] == '9') ip[--i] = '0';
+                if (i) {
+                    ip[i - 1]++;
+                } else {
+                    *--ip = '1';
+                    ilen++;
+                }
+            }
+        }
+    }
+
+    // Squeeze out the spare digit if unused, then place the point
+    if (ip != out) eclib_memmove(out, ip, ilen);
+    size_t len = ilen;
+    if (prec > 0 || alt) out[len++] = '.';
+    if (flen) {
+        eclib_memmove(out + len, fp, flen);
+        len += flen;
+    }
+    *trail = (size_t)prec - flen;
+    return len;
+}
+
+// --------------------------
+// Exponent form doubles
+// --------------------------
+// %e and %g round the exact value to a number of significant digits,
+// using the %f digit generators. Below one they ask for enough fraction
+// digits to get past the leading zeros.
+
+// A double has at most 767 significant digits; further ones are zeros
+#define FMT_SIG_MAX     800
+
+// ndig (1..FMT_SIG_MAX) significant digits of a positive finite double,
+// rounded half to even. *x10 gets the decimal exponent of the first.
+static void fmt_sig(uint64_t bits, size_t ndig, char* out, int* x10) {
+    uint64_t frac = bits & ((1ull << 52) - 1);
+    uint32_t bexp = (uint32_t)(bits >> 52) & 0x7FF;
+    uint64_t m = bexp ? (1ull << 52) | frac : frac;
+    int e = (bexp ? (int)bexp : 1) - 1023 - 52;
+    int s = e < 0 ? -e : 0;
+    size_t ilen = 0, flen = 0;
+    int sticky = 0;
+
+    *x10 = 0;
+    if (m == 0) {
+        eclib_memset(out, '0', ndig);
+        return;
+    }
+
+    // Integer digits, none for a value below one
+    if (e > 11) {
+        ilen = big_int_digits(m, e, out);
+    } else {
+        uint64_t iv = e >= 0 ? m << e : (s < 64 ? m >> s : 0);
+        if (iv) {
+            char tmp[24];
+            char* end = tmp + sizeof(tmp);
+            char* p = fmt_dec(end, iv);
+            ilen = (size_t)(end - p);
+            eclib_memcpy(out, p, ilen);
+        }
+    }
+
+    // Fraction digits up to one past the last kept. A value of at least
+    // 2^msb has at most -msb * log10(2) leading zeros (78913 / 2^18 is
+    // log10(2) rounded down, hence the extra one).
+    size_t want = ilen <= ndig ? ndig + 1 - ilen : 0;
+    if (ilen == 0) {
+        int msb = e + 63 - __builtin_clzll(m);
+        want += (size_t)(((int64_t)-msb * 78913) >> 18) + 1;
+    }
+    char* fp = out + ilen;
+    if (s > 124) {
+        flen = big_frac_digits(m, s, fp, want, &sticky);
+    } else if (s > 0) {
+        unsigned __int128 mask = ((unsigned __int128)1 << s) - 1;
+        unsigned __int128 f = (unsigned __int128)m & mask;
+        while (flen < want && f) {
+            f *= 10;
+            fp[flen++] = (char)('0' + (int)(f >> s));
+            f &= mask;
+        }
+        sticky = f != 0;
+    }
+    size_t len = ilen + flen;
+
+    size_t first = 0;
+    while (first < len && out[first] == '0') first++;
+    *x10 = (int)ilen - 1 - (int)first;
+
+    // Keep ndig digits and round half to even on what follows
+    size_t have = len - first;
+    char r = '0';
+    if (have > ndig) {
+        r = out[first + ndig];
+        for (size_t i = first + ndig + 1; i < len; i++) sticky |= out[i] != '0';
+        have = ndig;
+    }
+    eclib_memmove(out, out + first, have);
+    eclib_memset(out + have, '0', ndig - have);
+    if (r > '5' || (r == '5' && (sticky || (out[ndig - 1] & 1)))) {
+        size_t i = ndig;
+        while (i && out[i - 1] == '9') out[--i] = '0';
+        if (i) {
+            out[i - 1]++;
+        } else {
+            out[0] = '1';
+            (*x10)++;
+        }
+    }
+}
+
+// Shortest round-trip significant digits of a positive finite double;
+// returns their count. *x10 gets the decimal exponent of the first.
+static size_t fmt_sig_shortest(uint64_t bits, char* out, int* x10) {
+    uint64_t frac = bits & ((1ull << 52) - 1);
+    uint32_t bexp = (uint32_t)(bits >> 52) & 0x7FF;
+    char tmp[24];
+    char* end = tmp + sizeof(tmp);
+    char* p;
+    int32_t e10 = 0;
+
+    if ((bits << 1) == 0) {
+        out[0] = '0';
+        *x10 = 0;
+        return 1;
+    }
+
+    int32_t e2 = (int32_t)bexp - 1023 - 52;
+    uint64_t m2 = (1ull << 52) | frac;
+    if (bexp && e2 <= 0 && e2 >= -52 && (m2 & ((1ull << -e2) - 1)) == 0) {
+        p = fmt_dec(end, m2 >> -e2);
+    } else {
+        p = fmt_dec(end, dtoa_shortest(frac, bexp, &e10));
+    }
+    size_t n = (size_t)(end - p);
+    while (n > 1 && p[n - 1] == '0') {
+        n--;
+        e10++;
+    }
+    eclib_memcpy(out, p, n);
+    *x10 = e10 + (int)n - 1;
+    return n;
+}
+
+// %e or %g (conv lower case) of a positive finite double. The digits go
+// into out, *trail gets the zeros that follow them and sfx the exponent.
+static size_t fmt_exp(uint64_t bits, const fmt_spec_t* sp, char conv,
+                      int upper, char* out, size_t* trail, char* sfx,
+                      size_t* slen) {
+    char dig[FMT_FLOAT_BUF];
+    int alt = sp->flags & FMT_ALT;
+    size_t n, want;             // significant digits known, wanted
+    int x10;
+
+    if (sp->prec < 0) {
+        n = want = fmt_sig_shortest(bits, dig, &x10);
+    } else {
+        want = conv == 'e' ? (size_t)sp->prec + 1
+                           : (size_t)(sp->prec ? sp->prec : 1);
+        n = want < FMT_SIG_MAX ? want : FMT_SIG_MAX;
+        fmt_sig(bits, n, dig, &x10);
+    }
+
+    // %g: plain unless the exponent is below -4 or reaches the precision
+    // (6 without one), trailing zeros dropped unless '#'
+    int exp_form = 1;
+    if (conv == 'g') {
+        int p = sp->prec < 0 ? 6 : (int)want;
+        exp_form = x10 < -4 || x10 >= p;
+        if (!alt) {
+            while (n > 1 && dig[n - 1] == '0') n--;
+            want = n;
+        }
+    }
+
+    size_t len = 0;
+    *slen = 0;
+    if (exp_form) {
+        out[len++] = dig[0];
+        if (want > 1 || alt) out[len++] = '.';
+        eclib_memcpy(out + len, dig + 1, n - 1);
+        len += n - 1;
+        *trail = want - n;
+
+        unsigned ax = (unsigned)(x10 < 0 ? -x10 : x10);
+        sfx[(*slen)++] = upper ? 'E' : 'e';
+        sfx[(*slen)++] = x10 < 0 ? '-' : '+';
+        if (ax >= 100) sfx[(*slen)++] = (char)('0' + ax / 100);
+        sfx[(*slen)++] = DIGITS2[ax % 100 * 2];
+        sfx[(*slen)++] = DIGITS2[ax % 100 * 2 + 1];
+    } else if (x10 >= 0) {
+        size_t ip = (size_t)x10 + 1;
+        size_t known = n < ip ? n : ip;
+        eclib_memcpy(out, dig, known);
+        eclib_memset(out + known, '0', ip - known);
+        len = ip;
+        if (want > ip || alt) out[len++] = '.';
+        if (n > ip) {
+            eclib_memcpy(out + len, dig + ip, n - ip);
+            len += n - ip;
+        }
+        *trail = want > ip ? want - (n > ip ? n : ip) : 0;
+    } else {
+        size_t lead = (size_t)-x10 - 1;
+        out[len++] = '0';
+        out[len++] = '.';
+        eclib_memset(out + len, '0', lead);
+        len += lead;
+        eclib_memcpy(out + len, dig, n);
+        len += n;
+        *trail = want - n;
+    }
+    return len;
+}
+
+static void fmt_double(fmt_out_t* o, fmt_spec_t* sp, double d, char conv) {
+    union { double d; uint64_t u; } cv = { .d = d };
+    uint64_t bits = cv.u & ~(1ull << 63);
+    int upper = conv >= 'A' && conv <= 'Z';
+    char prefix[1];
+    size_t plen = 0;
+    char body[FMT_FLOAT_BUF];
+    char sfx[8];
+    size_t len, trail = 0, slen = 0;
+
+    if (cv.u >> 63) prefix[plen++] = '-';
+    else if (sp->flags & FMT_PLUS) prefix[plen++] = '+';
+    else if (sp->flags & FMT_SPACE) prefix[plen++] = ' ';
+
+    if ((bits >> 52) == 0x7FF) {
+        const char* s = (bits << 12) ? (upper ? "NAN" : "nan")
+                                     : (upper ? "INF" : "inf");
+        sp->flags &= ~FMT_ZERO;
+        out_field(o, sp, prefix, plen, 0, s, 3, 0);
+        return;
+    }
+    conv |= 0x20;
+    if (conv == 'e' || conv == 'g') {
+        len = fmt_exp(bits, sp, conv, upper, body, &trail, sfx, &slen);
+    } else if (sp->prec < 0) {
+        len = fmt_shortest(bits, body, &trail);
+    } else {
+        len = fmt_fixed(bits, sp->prec, sp->flags & FMT_ALT, body, &trail);
+    }
+    out_field_sfx(o, sp, prefix, plen, 0, body, len, trail, sfx, slen);
+}
+
+// --------------------------
+// Driver
+// --------------------------
+static void fmt_run(fmt_out_t* o, const char* fmt, va_list ap) {
+    for (;;) {
+        const char* lit = fmt;
+        while (*fmt && *fmt != '%') fmt++;
+        if (fmt != lit) out_write(o, lit, (size_t)(fmt - lit));
+        if (*fmt == '\0') return;
+
+        const char* start = fmt++;
+        fmt_spec_t sp = { 0, 0, -1 };
+
+        for (;; fmt++) {
+            if (*fmt == '-') sp.flags |= FMT_LEFT;
+            else if (*fmt == '+') sp.flags |= FMT_PLUS;
+            else if (*fmt == ' ') sp.flags |= FMT_SPACE;
+            else if (*fmt == '#') sp.flags |= FMT_ALT;
+            else if (*fmt == '0') sp.flags |= FMT_ZERO;
+            else break;
+        }
+        if (*fmt == '*') {
+            int w = va_arg(ap, int);
+            if (w < 0) {
+                sp.flags |= FMT_LEFT;
+                w = w == INT_MIN ? INT_MAX : -w;
+            }
+            sp.width = (size_t)w;
+            fmt++;
+        } else {
+            while (*fmt >= '0' && *fmt <= '9') {
+                sp.width = sp.width * 10 + (size_t)(*fmt++ - '0');
+            }
+        }
+        if (*fmt == '.') {
+            fmt++;
+            if (*fmt == '*') {
+                int pr = va_arg(ap, int);
+                sp.prec = pr < 0 ? -1 : pr;
+                fmt++;
+            } else {
+                long pr = 0;
+                while (*fmt >= '0' && *fmt <= '9') {
+                    if (pr < INT_MAX / 10) pr = pr * 10 + (*fmt - '0');
+                    fmt++;
+                }
+                sp.prec = (int)pr;
+            }
+        }
+
+        int len = LEN_INT;
+        switch (*fmt) {
+        case 'h':
+            len = LEN_SHORT;
+            if (*++fmt == 'h') { len = LEN_CHAR; fmt++; }
+            break;
+        case 'l':
+            len = LEN_LONG;
+            if (*++fmt == 'l') { len = LEN_LLONG; fmt++; }
+            break;
+        case 'z': len = LEN_SIZE; fmt++; break;
+        case 'j': len = LEN_MAX; fmt++; break;
+        case 't': len = LEN_PTRDIFF; fmt++; break;
+        case 'L': len = LEN_LDOUBLE; fmt++; break;
+        }
+
+        char conv = *fmt;
+        if (conv == '\0') {
+            out_write(o, start, (size_t)(fmt - start));
+            return;
+        }
+        fmt++;
+
+        switch (conv) {
+        case 'd':
+        case 'i': {
+            int64_t v;
+            switch (len) {
+            case LEN_CHAR: v = (signed char)va_arg(ap, int); break;
+            case LEN_SHORT: v = (short)va_arg(ap, int); break;
+            case LEN_LONG: v = va_arg(ap, long); break;
+            case LEN_LLONG: v = va_arg(ap, long long); break;
+            case LEN_SIZE: v = va_arg(ap, intptr_t); break;
+            case LEN_MAX: v = va_arg(ap, intmax_t); break;
+            case LEN_PTRDIFF: v = va_arg(ap, ptrdiff_t); break;
+            default: v = va_arg(ap, int); break;
+            }
+            // Negate in unsigned so INT64_MIN survives
+            uint64_t u = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+            fmt_int(o, &sp, u, v < 0, 'd');
+            break;
+        }
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o': {
+            uint64_t v;
+            switch (len) {
+            case LEN_CHAR: v = (unsigned char)va_arg(ap, unsigned); break;
+            case LEN_SHORT: v = (unsigned short)va_arg(ap, unsigned); break;
+            case LEN_LONG: v = va_arg(ap, unsigned long); break;
+            case LEN_LLONG: v = va_arg(ap, unsigned long long); break;
+            case LEN_SIZE: v = va_arg(ap, size_t); break;
+            case LEN_MAX: v = va_arg(ap, uintmax_t); break;
+            case LEN_PTRDIFF: v = va_arg(ap, uintptr_t); break;
+            default: v = va_arg(ap, unsigned); break;
+            }
+            fmt_int(o, &sp, v, 0, conv);
+            break;
+        }
+        case 'p': {
+            void* ptr = va_arg(ap, void*);
+            sp.flags &= ~FMT_ZERO;
+            if (ptr == NULL) {
+                out_field(o, &sp, NULL, 0, 0, "(nil)", 5, 0);
+            } else {
+                sp.flags |= FMT_ALT;
+                fmt_int(o, &sp, (uintptr_t)ptr, 0, 'x');
+            }
+            break;
+        }
+        case 'c': {
+            char c = (char)va_arg(ap, int);
+            sp.flags &= ~FMT_ZERO;
+            out_field(o, &sp, NULL, 0, 0, &c, 1, 0);
+            break;
+        }
+        case 's': {
+            const char* s = va_arg(ap, const char*);
+            if (s == NULL) s = "(null)";
+            size_t n = sp.prec >= 0 ? eclib_strnlen(s, (size_t)sp.prec)
+                                    : eclib_strlen(s);
+            sp.flags &= ~FMT_ZERO;
+            out_field(o, &sp, NULL, 0, 0, s, n, 0);
+            break;
+        }
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G': {
+            double d = len == LEN_LDOUBLE ? (double)va_arg(ap, long double)
+                                          : va_arg(ap, double);
+            fmt_double(o, &sp, d, conv);
+            break;
+        }
+        case '%':
+            out_write(o, "%", 1);
+            break;
+        default:
+            // Unknown (including %n): copied through, no argument taken
+            out_write(o, start, (size_t)(fmt - start));
+            break;
+        }
+    }
+}
+
+static int fmt_result(const fmt_out_t* o) {
+    return o->total > INT_MAX ? -1 : (int)o->total;
+}
+
+int eclib_vsnprintf(char* buf, size_t size, const char* fmt, va_list ap) {
+    if (!fmt || (!buf && size)) return -1;
+
+    char dummy;
+    fmt_out_t o = {
+        .buf = size ? buf : &dummy,
+        .cap = size ? size - 1 : 0,
+        .len = 0,
+        .total = 0,
+        .sink = NULL,
+        .ctx = NULL,
+    };
+    va_list args;
+    va_copy(args, ap);
+    fmt_run(&o, fmt, args);
+    va_end(args);
+
+    if (size) buf[o.len] = '\0';
+    return fmt_result(&o);
+}
+
+int eclib_snprintf(char* buf, size_t size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int ret = eclib_vsnprintf(buf, size, fmt, args);
+    va_end(args);
+    return ret;
+}
+
+int eclib_vformat(eclib_sink_fn sink, void* ctx, const char* fmt, va_list ap) {
+    if (!sink || !fmt) return -1;
+
+    char buf[FMT_SINK_BUF];
+    fmt_out_t o = {
+        .buf = buf,
+        .cap = sizeof(buf),
+        .len = 0,
+        .total = 0,
+        .sink = sink,
+        .ctx = ctx,
+    };
+    va_list args;
+    va_copy(args, ap);
+    fmt_run(&o, fmt, args);
+    va_end(args);
+
+    out_flush(&o);
+    return fmt_result(&o);
+}
+
+int eclib_format(eclib_sink_fn sink, void* ctx, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int ret = eclib_vformat(sink, ctx, fmt, args);
+    va_end(args);
+    return ret;
+}
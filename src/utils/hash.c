@@ -0,0 +1,111 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/utils.h"
+#include "utils_internal.h"
+
+// Hashing
+// -------
+// wyhash: every step is one 64x64->128 multiply folded back to 64 bits,
+// inputs are read in overlapping 8-byte words, so short keys take no
+// loop at all and long ones run three independent lanes. Good enough to
+// put the low bits straight into a power-of-two table; not meant to
+// resist anyone who can see the output.
+
+static const uint64_t HASH_SECRET[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull,
+};
+
+static inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+    unsigned __int128 r = (unsigned __int128)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+static inline void hash_mum(uint64_t* a, uint64_t* b) {
+    unsigned __int128 r = (unsigned __int128)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+}
+
+static inline uint64_t hash_r8(const uint8_t* p) {
+    uint64_t v = *(const utils_u64*)p;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint64_t hash_r4(const uint8_t* p) {
+    uint32_t v = *(const utils_u32*)p;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+// 1 to 3 bytes: first, middle and last
+static inline uint64_t hash_r3(const uint8_t* p, size_t k) {
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+uint64_t eclib_hash_bytes(const void* data, size_t len, uint64_t seed) {
+    const uint8_t* p = data;
+    const uint64_t* s = HASH_SECRET;
+    uint64_t a, b;
+
+    seed ^= hash_mix(seed ^ s[0], s[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t mid = (len >> 3) << 2;
+            a = (hash_r4(p) << 32) | hash_r4(p + mid);
+            b = (hash_r4(p + len - 4) << 32) | hash_r4(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = hash_r3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = hash_mix(hash_r8(p) ^ s[1], hash_r8(p + 8) ^ seed);
+                see1 = hash_mix(hash_r8(p + 16) ^ s[2], hash_r8(p + 24) ^ see1);
+                see2 = hash_mix(hash_r8(p + 32) ^ s[3], hash_r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = hash_mix(hash_r8(p) ^ s[1], hash_r8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // Last 16 bytes, overlapping the ones already mixed
+        a = hash_r8(p + i - 16);
+        b = hash_r8(p + i - 8);
+    }
+    a ^= s[1];
+    b ^= seed;
+    hash_mum(&a, &b);
+    return hash_mix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
+uint64_t eclib_hash_str(const char* str, uint64_t seed) {
+    if (str == NULL) return eclib_hash_bytes(NULL, 0, seed);
+    return eclib_hash_bytes(str, eclib_strlen(str), seed);
+}
+
+uint64_t eclib_hash_u64(uint64_t value, uint64_t seed) {
+    return hash_mix(value ^ seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+}
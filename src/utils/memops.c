@@ -0,0 +1,117 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "utils_internal.h"
+
+// memcpy / memmove / memset
+// -------------------------
+// One body (memops_impl.h) instantiated per vector width: 64-bit words for
+// the portable versions, SSE2 and AVX2 on x86-64, NEON on AArch64. The
+// SIMD versions use GCC vector types for plain loads and stores, so only
+// the non-temporal stores need intrinsics or asm.
+
+// n <= 16; all loads happen before the first store
+static inline __attribute__((always_inline))
+void copy_le16(uint8_t* d, const uint8_t* s, size_t n) {
+    if (n >= 8) {
+        uint64_t a = *(const utils_u64*)s, b = *(const utils_u64*)(s + n - 8);
+        *(utils_u64*)d = a;
+        *(utils_u64*)(d + n - 8) = b;
+    } else if (n >= 4) {
+        uint32_t a = *(const utils_u32*)s, b = *(const utils_u32*)(s + n - 4);
+        *(utils_u32*)d = a;
+        *(utils_u32*)(d + n - 4) = b;
+    } else if (n >= 2) {
+        uint16_t a = *(const utils_u16*)s, b = *(const utils_u16*)(s + n - 2);
+        *(utils_u16*)d = a;
+        *(utils_u16*)(d + n - 2) = b;
+    } else if (n) {
+        *d = *s;
+    }
+}
+
+// n <= 16
+static inline __attribute__((always_inline))
+void set_le16(uint8_t* d, uint8_t c, size_t n) {
+    uint64_t v = 0x0101010101010101ull * c;
+    if (n >= 8) {
+        *(utils_u64*)d = v;
+        *(utils_u64*)(d + n - 8) = v;
+    } else if (n >= 4) {
+        *(utils_u32*)d = (uint32_t)v;
+        *(utils_u32*)(d + n - 4) = (uint32_t)v;
+    } else if (n >= 2) {
+        *(utils_u16*)d = (uint16_t)v;
+        *(utils_u16*)(d + n - 2) = (uint16_t)v;
+    } else if (n) {
+        *d = c;
+    }
+}
+
+// Portable: a 64-bit word at a time
+#define MEMOPS_SUFFIX       generic
+#define MEMOPS_W            8
+#define MEMOPS_VU           utils_u64
+#define MEMOPS_VA           utils_u64a
+#define MEMOPS_SPLAT(c)     (0x0101010101010101ull * (c))
+#include "memops_impl.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+// SSE2 is part of x86-64 itself
+#define MEMOPS_SUFFIX       sse2
+#define MEMOPS_W            16
+#define MEMOPS_VU           vec16_u
+#define MEMOPS_VA           vec16_a
+#define MEMOPS_SPLAT(c)     ((vec16_a){0} + (c))
+#define MEMOPS_STREAM4(p, a, b, c, e) do {                  \
+        _mm_stream_si128((__m128i*)(p), (__m128i)(a));      \
+        _mm_stream_si128((__m128i*)(p) + 1, (__m128i)(b));  \
+        _mm_stream_si128((__m128i*)(p) + 2, (__m128i)(c));  \
+        _mm_stream_si128((__m128i*)(p) + 3, (__m128i)(e));  \
+    } while (0)
+#define MEMOPS_STREAM_END() _mm_sfence()
+#include "memops_impl.h"
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define MEMOPS_SUFFIX       avx2
+#define MEMOPS_W            32
+#define MEMOPS_VU           vec32_u
+#define MEMOPS_VA           vec32_a
+#define MEMOPS_SPLAT(c)     ((vec32_a){0} + (c))
+#define MEMOPS_STREAM4(p, a, b, c, e) do {                      \
+        _mm256_stream_si256((__m256i*)(p), (__m256i)(a));       \
+        _mm256_stream_si256((__m256i*)(p) + 1, (__m256i)(b));   \
+        _mm256_stream_si256((__m256i*)(p) + 2, (__m256i)(c));   \
+        _mm256_stream_si256((__m256i*)(p) + 3, (__m256i)(e));   \
+    } while (0)
+#define MEMOPS_STREAM_END() _mm_sfence()
+#include "memops_impl.h"
+#pragma GCC pop_options
+
+#elif defined(__aarch64__)
+
+// Advanced SIMD is mandatory on AArch64. STNP is only a hint and keeps
+// normal ordering, so no fence is needed after it.
+#define MEMOPS_SUFFIX       neon
+#define MEMOPS_W            16
+#define MEMOPS_VU           vec16_u
+#define MEMOPS_VA           vec16_a
+#define MEMOPS_SPLAT(c)     ((vec16_a){0} + (c))
+#define MEMOPS_STREAM4(p, a, b, c, e)                                   \
+    __asm__ volatile("stnp %q1, %q2, [%0]\n\t"                          \
+                     "stnp %q3, %q4, [%0, #32]"                         \
+                     :: "r"(p), "w"(a), "w"(b), "w"(c), "w"(e) : "memory")
+#define MEMOPS_STREAM_END() do { } while (0)
+#include "memops_impl.h"
+
+#endif
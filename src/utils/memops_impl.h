@@ -0,0 +1,219 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+// memcpy/memmove/memset body, included by memops.c once per vector width.
+// No include guard on purpose. The includer defines:
+//   MEMOPS_SUFFIX        name suffix (utils_memcpy_<suffix> ...)
+//   MEMOPS_W             bytes per vector
+//   MEMOPS_VU/MEMOPS_VA  unaligned / aligned vector types (may_alias)
+//   MEMOPS_SPLAT(c)      vector with every byte set to c
+//   MEMOPS_STREAM4(p, a, b, c, e), MEMOPS_STREAM_END()
+//                        optional non-temporal store of 4 vectors at an
+//                        aligned p, and the fence that ends a run of them
+//
+// Everything above 2 * MEMOPS_W bytes works the same way: the first and
+// last vector are loaded up front and stored unaligned, the middle is
+// copied in aligned vectors of the destination. Blocks are loaded before
+// they are stored and head/tail go last, which makes the forward loop
+// safe for dest < src and the backward one for dest > src.
+
+#define MEMOPS_CAT2(a, b)   a##_##b
+#define MEMOPS_CAT(a, b)    MEMOPS_CAT2(a, b)
+#define MEMOPS_FN(name)     MEMOPS_CAT(name, MEMOPS_SUFFIX)
+#define MEMOPS_LOAD(p)      (*(const MEMOPS_VU*)(p))
+#define MEMOPS_STORE(p, v)  (*(MEMOPS_VU*)(p) = (v))
+#define MEMOPS_STORE_A(p, v) (*(MEMOPS_VA*)(p) = (v))
+
+// n <= 2 * MEMOPS_W; all loads happen before the first store
+static inline __attribute__((always_inline))
+void MEMOPS_FN(copy_small)(uint8_t* d, const uint8_t* s, size_t n) {
+#if MEMOPS_W >= 32
+    if (n >= 32) {
+        MEMOPS_VA a = MEMOPS_LOAD(s), b = MEMOPS_LOAD(s + n - 32);
+        MEMOPS_STORE(d, a);
+        MEMOPS_STORE(d + n - 32, b);
+        return;
+    }
+#endif
+#if MEMOPS_W >= 16
+    if (n >= 16) {
+        vec16_a a = *(const vec16_u*)s, b = *(const vec16_u*)(s + n - 16);
+        *(vec16_u*)d = a;
+        *(vec16_u*)(d + n - 16) = b;
+        return;
+    }
+#endif
+    copy_le16(d, s, n);
+}
+
+// n > 2 * MEMOPS_W
+static inline __attribute__((always_inline))
+void MEMOPS_FN(copy_fwd)(uint8_t* d, const uint8_t* s, size_t n, int stream) {
+    MEMOPS_VA head = MEMOPS_LOAD(s);
+    MEMOPS_VA tail = MEMOPS_LOAD(s + n - MEMOPS_W);
+    size_t off = MEMOPS_W - ((uintptr_t)d & (MEMOPS_W - 1));
+
+#ifdef MEMOPS_STREAM4
+    if (stream) {
+        while (n - off > 4 * MEMOPS_W) {
+            MEMOPS_VA a = MEMOPS_LOAD(s + off);
+            MEMOPS_VA b = MEMOPS_LOAD(s + off + MEMOPS_W);
+            MEMOPS_VA c = MEMOPS_LOAD(s + off + 2 * MEMOPS_W);
+            MEMOPS_VA e = MEMOPS_LOAD(s + off + 3 * MEMOPS_W);
+            MEMOPS_STREAM4(d + off, a, b, c, e);
+            off += 4 * MEMOPS_W;
+        }
+        MEMOPS_STREAM_END();
+    }
+#else
+    (void)stream;
+#endif
+    while (n - off > 4 * MEMOPS_W) {
+        MEMOPS_VA a = MEMOPS_LOAD(s + off);
+        MEMOPS_VA b = MEMOPS_LOAD(s + off + MEMOPS_W);
+        MEMOPS_VA c = MEMOPS_LOAD(s + off + 2 * MEMOPS_W);
+        MEMOPS_VA e = MEMOPS_LOAD(s + off + 3 * MEMOPS_W);
+        MEMOPS_STORE_A(d + off, a);
+        MEMOPS_STORE_A(d + off + MEMOPS_W, b);
+        MEMOPS_STORE_A(d + off + 2 * MEMOPS_W, c);
+        MEMOPS_STORE_A(d + off + 3 * MEMOPS_W, e);
+        off += 4 * MEMOPS_W;
+    }
+    while (n - off > MEMOPS_W) {
+        MEMOPS_VA a = MEMOPS_LOAD(s + off);
+        MEMOPS_STORE_A(d + off, a);
+        off += MEMOPS_W;
+    }
+    MEMOPS_STORE(d, head);
+    MEMOPS_STORE(d + n - MEMOPS_W, tail);
+}
+
+// n > 2 * MEMOPS_W, d > s
+static inline __attribute__((always_inline))
+void MEMOPS_FN(copy_bwd)(uint8_t* d, const uint8_t* s, size_t n) {
+    MEMOPS_VA head = MEMOPS_LOAD(s);
+    MEMOPS_VA tail = MEMOPS_LOAD(s + n - MEMOPS_W);
+    size_t end = n - ((uintptr_t)(d + n) & (MEMOPS_W - 1));
+
+    while (end > 4 * MEMOPS_W) {
+        end -= 4 * MEMOPS_W;
+        MEMOPS_VA a = MEMOPS_LOAD(s + end);
+        MEMOPS_VA b = MEMOPS_LOAD(s + end + MEMOPS_W);
+        MEMOPS_VA c = MEMOPS_LOAD(s + end + 2 * MEMOPS_W);
+        MEMOPS_VA e = MEMOPS_LOAD(s + end + 3 * MEMOPS_W);
+        MEMOPS_STORE_A(d + end, a);
+        MEMOPS_STORE_A(d + end + MEMOPS_W, b);
+        MEMOPS_STORE_A(d + end + 2 * MEMOPS_W, c);
+        MEMOPS_STORE_A(d + end + 3 * MEMOPS_W, e);
+    }
+    while (end > MEMOPS_W) {
+        end -= MEMOPS_W;
+        MEMOPS_VA a = MEMOPS_LOAD(s + end);
+        MEMOPS_STORE_A(d + end, a);
+    }
+    MEMOPS_STORE(d, head);
+    MEMOPS_STORE(d + n - MEMOPS_W, tail);
+}
+
+ECLIB_NO_LIBCALL
+void* MEMOPS_FN(utils_memcpy)(void* dest, const void* src, size_t len) {
+    if (len <= 2 * MEMOPS_W) {
+        MEMOPS_FN(copy_small)(dest, src, len);
+    } else {
+        MEMOPS_FN(copy_fwd)(dest, src, len, len >= g_utils_ops.nt_threshold);
+    }
+    return dest;
+}
+
+ECLIB_NO_LIBCALL
+void* MEMOPS_FN(utils_memmove)(void* dest, const void* src, size_t len) {
+    uint8_t* d = dest;
+    const uint8_t* s = src;
+
+    if (len <= 2 * MEMOPS_W) {
+        MEMOPS_FN(copy_small)(d, s, len);
+    } else if ((uintptr_t)d - (uintptr_t)s >= len) {
+        // dest below src, or no overlap at all
+        int disjoint = (uintptr_t)s - (uintptr_t)d >= len;
+        MEMOPS_FN(copy_fwd)(d, s, len,
+                            disjoint && len >= g_utils_ops.nt_threshold);
+    } else {
+        MEMOPS_FN(copy_bwd)(d, s, len);
+    }
+    return dest;
+}
+
+ECLIB_NO_LIBCALL
+void* MEMOPS_FN(utils_memset)(void* ptr, int value, size_t len) {
+    uint8_t* d = ptr;
+    uint8_t c = (uint8_t)value;
+
+    if (len <= 2 * MEMOPS_W) {
+#if MEMOPS_W >= 32
+        if (len >= 32) {
+            MEMOPS_VA v = MEMOPS_SPLAT(c);
+            MEMOPS_STORE(d, v);
+            MEMOPS_STORE(d + len - 32, v);
+            return ptr;
+        }
+#endif
+#if MEMOPS_W >= 16
+        if (len >= 16) {
+            vec16_a v = (vec16_a){0} + c;
+            *(vec16_u*)d = v;
+            *(vec16_u*)(d + len - 16) = v;
+            return ptr;
+        }
+#endif
+        set_le16(d, c, len);
+        return ptr;
+    }
+
+    MEMOPS_VA v = MEMOPS_SPLAT(c);
+    size_t off = MEMOPS_W - ((uintptr_t)d & (MEMOPS_W - 1));
+    MEMOPS_STORE(d, v);
+    MEMOPS_STORE(d + len - MEMOPS_W, v);
+
+#ifdef MEMOPS_STREAM4
+    if (len >= g_utils_ops.nt_threshold) {
+        while (len - off > 4 * MEMOPS_W) {
+            MEMOPS_STREAM4(d + off, v, v, v, v);
+            off += 4 * MEMOPS_W;
+        }
+        MEMOPS_STREAM_END();
+    }
+#endif
+    while (len - off > 4 * MEMOPS_W) {
+        MEMOPS_STORE_A(d + off, v);
+        MEMOPS_STORE_A(d + off + MEMOPS_W, v);
+        MEMOPS_STORE_A(d + off + 2 * MEMOPS_W, v);
+        MEMOPS_STORE_A(d + off + 3 * MEMOPS_W, v);
+        off += 4 * MEMOPS_W;
+    }
+    while (len - off > MEMOPS_W) {
+        MEMOPS_STORE_A(d + off, v);
+        off += MEMOPS_W;
+    }
+    return ptr;
+}
+
+#undef MEMOPS_CAT2
+#undef MEMOPS_CAT
+#undef MEMOPS_FN
+#undef MEMOPS_LOAD
+#undef MEMOPS_STORE
+#undef MEMOPS_STORE_A
+#undef MEMOPS_SUFFIX
+#undef MEMOPS_W
+#undef MEMOPS_VU
+#undef MEMOPS_VA
+#undef MEMOPS_SPLAT
+#undef MEMOPS_STREAM4
+#undef MEMOPS_STREAM_END
@@ -0,0 +1,632 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/utils.h"
+#include "eclib/error.h"
+#include "utils_internal.h"
+#include "pow10_table.h"
+#include <limits.h>
+
+// Number parsing
+// --------------
+// Every parser takes a limit: NULL for NUL-terminated strings, the end of
+// the view for the eclib_parse_* variants. Decimal digits go eight at a time
+// through a 64-bit word where that is safe (inside the view, or not
+// crossing a page for strings). Doubles are tried with exact double
+// arithmetic first, then Eisel-Lemire against PARSE_POW10, and only the
+// cases those cannot decide fall back to a long decimal.
+
+// Byte at p, or NUL at the limit -- which stops every rule below
+#define AT(p, lim)      (((lim) == NULL || (p) < (lim)) ? (uint8_t)*(p) : 0)
+
+static inline int is_space(uint8_t c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline int lower(uint8_t c) {
+    return c | 0x20;
+}
+
+// --------------------------
+// Eight digits at a time
+// --------------------------
+static inline int can_load8(const char* p, const char* lim) {
+    if (lim) return lim - p >= 8;
+    return ((uintptr_t)p & (UTILS_PAGE_SIZE - 1)) <= UTILS_PAGE_SIZE - 8;
+}
+
+// Little-endian load of 8 bytes; only called where can_load8 said so
+ECLIB_SCAN
+static inline uint64_t load8(const char* p) {
+    return *(const utils_u64*)p;
+}
+
+// Bytes of x - '0' that are not 0..9, as 0x80 in each such byte
+static inline uint64_t swar_nondigit(uint64_t t) {
+    uint64_t hi = t & 0xF0F0F0F0F0F0F0F0ull;
+    uint64_t lo = (t & 0x0F0F0F0F0F0F0F0Full) + 0x0606060606060606ull;
+    uint64_t bad = hi | (lo & 0xF0F0F0F0F0F0F0F0ull);
+    // Fold every set bit of a byte into its top bit
+    bad |= bad << 1;
+    bad |= bad << 2;
+    bad |= bad << 4;
+    return bad & 0x8080808080808080ull;
+}
+
+// Value of eight digit bytes (already minus '0'), first digit lowest
+static inline uint32_t swar_value8(uint64_t t) {
+    t = (t * 10) + (t >> 8);
+    t = (((t & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+         (((t >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    return (uint32_t)t;
+}
+
+// --------------------------
+// Integers
+// --------------------------
+static inline int digit_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = (uint8_t)lower(c);
+    if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+    return 99;
+}
+
+// Magnitude of the digits at p in base; *ovf set if it does not fit.
+// Returns the end of the digits.
+static const char* parse_digits(const char* p, const char* lim, int base,
+                                uint64_t* out, int* ovf) {
+    uint64_t v = 0;
+
+    if (base == 10) {
+        while (can_load8(p, lim)) {
+            uint64_t t = load8(p) - 0x3030303030303030ull;
+            uint64_t bad = swar_nondigit(t);
+            size_t n = bad ? (size_t)__builtin_ctzll(bad) >> 3 : 8;
+            if (n == 0) break;
+            // Keep the n digits, as the high bytes of an 8-digit number
+            t <<= 8 * (8 - n);
+            static const uint64_t pow10[9] = {
+                1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+            };
+            if (__builtin_mul_overflow(v, pow10[n], &v) ||
+                __builtin_add_overflow(v, swar_value8(t), &v)) {
+                *ovf = 1;
+            }
+            p += n;
+            if (n < 8) {
+                *out = v;
+                return p;
+            }
+        }
+    }
+    for (;;) {
+        int d = digit_value(AT(p, lim));
+        if (d >= base) break;
+        if (__builtin_mul_overflow(v, (uint64_t)base, &v) ||
+            __builtin_add_overflow(v, (uint64_t)d, &v)) {
+            *ovf = 1;
+        }
+        p++;
+    }
+    *out = v;
+    return p;
+}
+
+// [space][sign][0x|0]digits; returns the end, or s if there is no number
+static const char* parse_int(const char* s, const char* lim, int base,
+                             int skip_space, uint64_t* mag, int* neg,
+                             int* ovf) {
+    const char* p = s;
+    *mag = 0;
+    *neg = 0;
+    *ovf = 0;
+    if (base != 0 && (base < 2 || base > 36)) {
+        eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);
+        return s;
+    }
+
+    if (skip_space) {
+        while (is_space(AT(p, lim))) p++;
+    }
+    if (AT(p, lim) == '-' || AT(p, lim) == '+') {
+        *neg = *p == '-';
+        p++;
+    }
+    if ((base == 0 || base == 16) && AT(p, lim) == '0' &&
+        lower(AT(p + 1, lim)) == 'x' && digit_value(AT(p + 2, lim)) < 16) {
+        p += 2;
+        base = 16;
+    } else if (base == 0) {
+        base = AT(p, lim) == '0' ? 8 : 10;
+    }
+
+    const char* end = parse_digits(p, lim, base, mag, ovf);
+    return end == p ? s : end;
+}
+
+static int64_t clamp_signed(uint64_t mag, int neg, int* ovf) {
+    if (neg) {
+        if (mag > (uint64_t)INT64_MAX + 1) *ovf = 1;
+        return *ovf ? INT64_MIN : (int64_t)(0 - mag);
+    }
+    if (mag > INT64_MAX) *ovf = 1;
+    return *ovf ? INT64_MAX : (int64_t)mag;
+}
+
+long eclib_strtol(const char* s, char** end, int base) {
+    uint64_t mag;
+    int neg, ovf;
+    if (s == NULL) return 0;
+
+    const char* e = parse_int(s, NULL, base, 1, &mag, &neg, &ovf);
+    int64_t v = clamp_signed(mag, neg, &ovf);
+#if LONG_MAX < INT64_MAX
+    if (v > LONG_MAX || v < LONG_MIN) {
+        ovf = 1;
+        v = v > 0 ? LONG_MAX : LONG_MIN;
+    }
+#endif
+    if (ovf) eclib_set_last_err(ECLIB_ECLIB_OUT_OF_RANGE);
+    if (end) *end = (char*)e;
+    return (long)v;
+}
+
+unsigned long long eclib_strtoull(const char* s, char** end, int base) {
+    uint64_t mag;
+    int neg, ovf;
+    if (s == NULL) return 0;
+
+    const char* e = parse_int(s, NULL, base, 1, &mag, &neg, &ovf);
+    if (end) *end = (char*)e;
+    if (ovf) {
+        eclib_set_last_err(ECLIB_ECLIB_OUT_OF_RANGE);
+        return ULLONG_MAX;
+    }
+    return neg ? 0 - mag : mag;
+}
+
+size_t eclib_parse_i64(const char* s, size_t len, int base, int64_t* out) {
+    uint64_t mag;
+    int neg, ovf;
+    if (s == NULL) return 0;
+
+    const char* e = parse_int(s, s + len, base, 0, &mag, &neg, &ovf);
+    if (e == s) return 0;
+    int64_t v = clamp_signed(mag, neg, &ovf);
+    if (ovf) eclib_set_last_err(ECLIB_ECLIB_OUT_OF_RANGE);
+    if (out) *out = v;
+    return (size_t)(e - s);
+}
+
+size_t eclib_parse_u64(const char* s, size_t len, int base, uint64_t* out) {
+    uint64_t mag;
+    int neg, ovf;
+    if (s == NULL) return 0;
+
+    const char* e = parse_int(s, s + len, base, 0, &mag, &neg, &ovf);
+    if (e == s) return 0;
+    if (neg && mag) ovf = 1;             // nothing negative fits
+    if (ovf) eclib_set_last_err(ECLIB_ECLIB_OUT_OF_RANGE);
+    if (out) *out = ovf ? (neg ? 0 : UINT64_MAX) : mag;
+    return (size_t)(e - s);
+}
+
+// --------------------------
+// Doubles: Eisel-Lemire
+// --------------------------
+static inline double from_bits(uint64_t u) {
+    union { uint64_t u; double d; } cv = { .u = u };
+    return cv.d;
+}
+
+// w * 10^e10 correctly rounded, w != 0. Returns 0 when the 128-bit
+// product cannot decide the rounding or the result is subnormal.
+static int eisel_lemire(uint64_t w, int e10, uint64_t* bits) {
+    if (e10 < PARSE_POW10_MIN || e10 > PARSE_POW10_MAX) return 0;
+    const uint64_t* pw = PARSE_POW10[e10 - PARSE_POW10_MIN];
+
+    int clz = __builtin_clzll(w);
+    w <<= clz;
+    // floor(e10 * log2(10)) + 64 + bias, minus the normalisation
+    uint64_t e2 = (uint64_t)(((217706 * e10) >> 16) + 64 + 1023) - (uint64_t)clz;
+
+    unsigned __int128 x = (unsigned __int128)w * pw[1];
+    uint64_t hi = (uint64_t)(x >> 64), lo = (uint64_t)x;
+
+    // The low bits are all ones: the truncated table entry may matter
+    if ((hi & 0x1FF) == 0x1FF && lo + w < w) {
+        unsigned __int128 y = (unsigned __int128)w * pw[0];
+        uint64_t yhi = (uint64_t)(y >> 64), ylo = (uint64_t)y;
+        uint64_t mlo = lo + yhi;
+        uint64_t mhi = hi + (mlo < lo);
+        if ((mhi & 0x1FF) == 0x1FF && mlo + 1 == 0 && ylo + w < w) return 0;
+        hi = mhi;
+        lo = mlo;
+    }
+
+    uint64_t msb = hi >> 63;
+    uint64_t mant = hi >> (msb + 9);
+    e2 -= 1 ^ msb;
+
+    // Exactly halfway between two doubles: cannot tell from here
+    if (lo == 0 && (hi & 0x1FF) == 0 && (mant & 3) == 1) return 0;
+
+    mant += mant & 1;
+    mant >>= 1;
+    if (mant >> 53) {
+        mant >>= 1;
+        e2++;
+    }
+    if (e2 - 1 >= 0x7FF - 1) return 0;
+    *bits = (e2 << 52) | (mant & ((1ull << 52) - 1));
+    return 1;
+}
+
+// --------------------------
+// Doubles: long decimal
+// --------------------------
+// The slow path: the decimal digits themselves, scaled by powers of two
+// until the mantissa can be read off and rounded. Only reached for
+// inputs within a hair of halfway between two doubles, or subnormals.
+
+#define DEC_DIGITS      800
+#define DEC_MAX_SHIFT   60
+
+typedef struct {
+    uint8_t d[DEC_DIGITS];      // digit values, most significant first
+    int nd;                     // digits in use
+    int dp;                     // position of the decimal point in d
+    int trunc;                  // non-zero digits were dropped
+} decimal_t;
+
+static void dec_trim(decimal_t* a) {
+    while (a->nd > 0 && a->d[a->nd - 1] == 0) a->nd--;
+    if (a->nd == 0) a->dp = 0;
+}
+
+static void dec_rshift(decimal_t* a, unsigned k) {
+    int r = 0, w = 0;
+    uint64_t n = 0;
+    uint64_t mask = (1ull << k) - 1;
+
+    // Enough leading digits for the first output digit
+    for (; (n >> k) == 0; r++) {
+        if (r >= a->nd) {
+            if (n == 0) {
+                a->nd = 0;
+                return;
+            }
+            while ((n >> k) == 0) {
+                n *= 10;
+                r++;
+            }
+            break;
+        }
+        n = n * 10 + a->d[r];
+    }
+    a->dp -= r - 1;
+
+    for (; r < a->nd; r++) {
+        uint64_t c = a->d[r];
+        a->d[w++] = (uint8_t)(n >> k);
+        n = (n & mask) * 10 + c;
+    }
+    while (n > 0) {
+        uint64_t dig = n >> k;
+        if (w < DEC_DIGITS) a->d[w++] = (uint8_t)dig;
+        else if (dig > 0) a->trunc = 1;
+        n = (n & mask) * 10;
+    }
+    a->nd = w;
+    dec_trim(a);
+}
+
+static void dec_lshift(decimal_t* a, unsigned k) {
+    // At most this many new digits in front (k * log10(2), rounded up)
+    int delta = (int)((k * 1233u) >> 12) + 1;
+    int w = a->nd + delta;
+    uint64_t n = 0;
+
+    for (int r = a->nd - 1; r >= 0; r--) {
+        n += (uint64_t)a->d[r] << k;
+        uint64_t q = n / 10;
+        w--;
+        if (w < DEC_DIGITS) a->d[w] = (uint8_t)(n - q * 10);
+        else if (n - q * 10) a->trunc = 1;
+        n = q;
+    }
+    while (n > 0) {
+        uint64_t q = n / 10;
+        w--;
+        if (w < DEC_DIGITS) a->d[w] = (uint8_t)(n - q * 10);
+        else if (n - q * 10) a->trunc = 1;
+        n = q;
+    }
+
+    // w is how far the estimate overshot; close the gap
+    int nd = a->nd + delta;
+    if (nd > DEC_DIGITS) nd = DEC_DIGITS;
+    nd -= w;
+    if (w) eclib_memmove(a->d, a->d + w, (size_t)nd);
+    a->nd = nd;
+    a->dp += delta - w;
+    dec_trim(a);
+}
+
+static void dec_shift(decimal_t* a, int k) {
+    if (a->nd == 0) return;
+    if (k > 0) {
+        for (; k > DEC_MAX_SHIFT; k -= DEC_MAX_SHIFT) dec_lshift(a, DEC_MAX_SHIFT);
+        dec_lshift(a, (unsigned)k);
+    } else if (k < 0) {
+        for (; k < -DEC_MAX_SHIFT; k += DEC_MAX_SHIFT) dec_rshift(a, DEC_MAX_SHIFT);
+        dec_rshift(a, (unsigned)-k);
+    }
+}
+
+// Integer part, rounded half to even (dropped digits count as above half)
+static uint64_t dec_round(const decimal_t* a) {
+    uint64_t n = 0;
+    int i;
+    if (a->dp > 20) return UINT64_MAX;
+    for (i = 0; i < a->dp && i < a->nd; i++) n = n * 10 + a->d[i];
+    for (; i < a->dp; i++) n *= 10;
+
+    int nd = a->dp;
+    if (nd >= 0 && nd < a->nd) {
+        int up;
+        if (a->d[nd] == 5 && nd + 1 == a->nd) {
+            up = a->trunc || (nd > 0 && (a->d[nd - 1] & 1));
+        } else {
+            up = a->d[nd] >= 5;
+        }
+        n += (uint64_t)up;
+    }
+    return n;
+}
+
+// Bits of the double nearest to a (sign not included)
+static uint64_t dec_to_bits(decimal_t* a) {
+    static const int powtab[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    const int bias = -1023;
+    int exp = 0;
+    uint64_t mant;
+
+    if (a->nd == 0) return 0;
+    if (a->dp > 310) return 0x7FFull << 52;
+    if (a->dp < -330) return 0;
+
+    // Scale into [0.5, 1)
+    while (a->dp > 0) {
+        int n = a->dp >= 9 ? 27 : powtab[a->dp];
+        dec_shift(a, -n);
+        exp += n;
+    }
+    while (a->dp < 0 || (a->dp == 0 && a->d[0] < 5)) {
+        int n = -a->dp >= 9 ? 27 : powtab[-a->dp];
+        dec_shift(a, n);
+        exp -= n;
+    }
+    exp--;                      // doubles are [1, 2) times a power of two
+
+    if (exp < bias + 1) {
+        int n = bias + 1 - exp;
+        dec_shift(a, -n);
+        exp += n;
+    }
+    if (exp - bias >= 0x7FF) return 0x7FFull << 52;
+
+    dec_shift(a, 53);
+    mant = dec_round(a);
+    if (mant == 2ull << 52) {
+        mant >>= 1;
+        exp++;
+        if (exp - bias >= 0x7FF) return 0x7FFull << 52;
+    }
+    if ((mant & (1ull << 52)) == 0) exp = bias;         // subnormal
+    return (mant & ((1ull << 52) - 1)) | ((uint64_t)(exp - bias) << 52);
+}
+
+static uint64_t slow_bits(const char* p, const char* end, int64_t e10) {
+    decimal_t a;
+    int point = 0;
+    a.nd = 0;
+    a.dp = 0;
+    a.trunc = 0;
+
+    for (; p < end; p++) {
+        if (*p == '.') {
+            point = 1;
+            continue;
+        }
+        uint8_t c = (uint8_t)(*p - '0');
+        if (c == 0 && a.nd == 0) {
+            if (point) a.dp--;           // zeros right after the point
+            continue;
+        }
+        if (a.nd < DEC_DIGITS) a.d[a.nd++] = c;
+        else if (c) a.trunc = 1;
+        if (!point) a.dp++;
+    }
+    if (e10 > 100000) e10 = 100000;
+    if (e10 < -100000) e10 = -100000;
+    a.dp += (int)e10;
+    dec_trim(&a);
+    return dec_to_bits(&a);
+}
+
+// --------------------------
+// Doubles
+// --------------------------
+static const double EXACT_POW10[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// "inf", "infinity" or "nan" / "nan(chars)" at p, any case
+static const char* parse_special(const char* p, const char* lim, double* out) {
+    static const char inf[] = "infinity";
+    size_t n = 0;
+    while (n < 8 && lower(AT(p + n, lim)) == inf[n]) n++;
+    if (n >= 3) {
+        *out = from_bits(0x7FFull << 52);
+        return p + (n == 8 ? 8 : 3);
+    }
+    if (lower(AT(p, lim)) == 'n' && lower(AT(p + 1, lim)) == 'a' &&
+        lower(AT(p + 2, lim)) == 'n') {
+        const char* q = p + 3;
+        *out = from_bits(0x7FF8000000000000ull);
+        if (AT(q, lim) == '(') {
+            const char* r = q + 1;
+            uint8_t c;
+            while ((c = AT(r, lim)) == '_' || digit_value(c) < 36) r++;
+            if (AT(r, lim) == ')') q = r + 1;
+        }
+        return q;
+    }
+    return NULL;
+}
+
+static const char* parse_double(const char* s, const char* lim, int skip_space,
+                                double* out) {
+    const char* p = s;
+    int neg = 0;
+
+    if (skip_space) {
+        while (is_space(AT(p, lim))) p++;
+    }
+    if (AT(p, lim) == '-' || AT(p, lim) == '+') {
+        neg = *p == '-';
+        p++;
+    }
+
+    double special;
+    const char* sp = parse_special(p, lim, &special);
+    if (sp) {
+        *out = neg ? -special : special;
+        return sp;
+    }
+
+    // Mantissa: the first 19 significant digits go into w, later ones
+    // only move the exponent (and make the result inexact if non-zero)
+    const char* digits = p;
+    uint64_t w = 0;
+    int nsig = 0;
+    int64_t e10 = 0;
+    int many = 0;
+    int seen = 0;
+
+    for (int frac = 0; frac < 2; frac++) {
+        if (frac) {
+            if (AT(p, lim) != '.') break;
+            p++;
+        }
+        for (;;) {
+            if (nsig <= 19 - 8 && can_load8(p, lim)) {
+                uint64_t t = load8(p) - 0x3030303030303030ull;
+                if (swar_nondigit(t) == 0) {
+                    uint32_t v = swar_value8(t);
+                    if (w == 0 && v) nsig += 8 - (__builtin_ctzll(t) >> 3);
+                    else if (w) nsig += 8;
+                    w = w * 100000000 + v;
+                    if (frac) e10 -= 8;
+                    p += 8;
+                    seen = 1;
+                    continue;
+                }
+            }
+            uint8_t c = (uint8_t)(AT(p, lim) - '0');
+            if (c > 9) break;
+            seen = 1;
+            p++;
+            if (w == 0 && c == 0) {
+                if (frac) e10--;
+            } else if (nsig < 19) {
+                w = w * 10 + c;
+                nsig++;
+                if (frac) e10--;
+            } else {
+                many |= c != 0;
+                if (!frac) e10++;
+            }
+        }
+    }
+    if (!seen) return s;
+    const char* digits_end = p;
+
+    // Exponent, only taken if digits follow the 'e'
+    int64_t ex = 0;
+    if (lower(AT(p, lim)) == 'e') {
+        const char* q = p + 1;
+        int eneg = 0;
+        if (AT(q, lim) == '-' || AT(q, lim) == '+') {
+            eneg = *q == '-';
+            q++;
+        }
+        if (AT(q, lim) - (unsigned)'0' <= 9) {
+            uint8_t c;
+            while ((c = (uint8_t)(AT(q, lim) - '0')) <= 9) {
+                if (ex < 1000000) ex = ex * 10 + c;
+                q++;
+            }
+            if (eneg) ex = -ex;
+            p = q;
+        }
+    }
+
+    uint64_t bits = 0;
+    e10 += ex;
+    if (w == 0) {
+        bits = 0;
+    } else if (!many && w <= (1ull << 53) && e10 >= -22 && e10 <= 22) {
+        // Both operands exact, so one IEEE operation rounds correctly
+        double d = (double)w;
+        d = e10 < 0 ? d / EXACT_POW10[-e10] : d * EXACT_POW10[e10];
+        union { double d; uint64_t u; } cv = { .d = d };
+        bits = cv.u;
+    } else if (e10 < -342) {
+        bits = 0;
+    } else if (e10 > 308) {
+        bits = 0x7FFull << 52;
+    } else {
+        uint64_t b2;
+        int ok = eisel_lemire(w, (int)e10, &bits);
+        // With digits cut off the value lies in [w, w + 1) * 10^e10;
+        // if both ends round the same way so does the value
+        if (ok && many) ok = eisel_lemire(w + 1, (int)e10, &b2) && b2 == bits;
+        if (!ok) bits = slow_bits(digits, digits_end, ex);
+    }
+
+    if ((bits >> 52) == 0x7FF || (bits == 0 && w != 0)) {
+        eclib_set_last_err(ECLIB_ECLIB_OUT_OF_RANGE);
+    }
+    if (neg) bits |= 1ull << 63;
+    *out = from_bits(bits);
+    return p;
+}
+
+double eclib_strtod(const char* s, char** end) {
+    double v = 0.0;
+    if (s == NULL) return 0.0;
+
+    const char* e = parse_double(s, NULL, 1, &v);
+    if (end) *end = (char*)e;
+    return e == s ? 0.0 : v;
+}
+
+size_t eclib_parse_double(const char* s, size_t len, double* out) {
+    double v = 0.0;
+    if (s == NULL) return 0;
+
+    const char* e = parse_double(s, s + len, 0, &v);
+    if (e == s) return 0;
+    if (out) *out = v;
+    return (size_t)(e - s);
+}
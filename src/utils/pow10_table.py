@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+#
+# ECLib - E-comOS C Library
+# Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+#
+# This file is part of ECLib.
+# ECLib is free library; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 2.1 of the License, or
+# (at your option) any later version.
+#
+# Writes pow10_table.h:  python3 pow10_table.py > pow10_table.h
+# Exponents outside the range make eisel_lemire in parse.c give up and
+# leave the number to the slow path.
+
+POW10_MIN = -348
+POW10_MAX = 347
+
+HEADER = """\
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+// 10^e for PARSE_POW10_MIN <= e <= PARSE_POW10_MAX as 128-bit mantissas,
+// {low 64 bits, high 64 bits}: the top bit is set and the value is
+// rounded down. Equivalently 5^e, the power of two is in the exponent.
+// Used by the Eisel-Lemire conversion in parse.c.
+// Generated by pow10_table.py; do not edit by hand.
+#ifndef ECLIB_POW10_TABLE_H
+#define ECLIB_POW10_TABLE_H
+#include <stdint.h>
+"""
+
+MASK64 = (1 << 64) - 1
+
+
+def mantissa(e):
+    """5^e scaled into [2^127, 2^128), rounded down"""
+    if e >= 0:
+        p = 5 ** e
+        shift = p.bit_length() - 128
+        return p >> shift if shift >= 0 else p << -shift
+    d = 5 ** -e
+    # Enough quotient bits that the top 128 are exact
+    q = (1 << (d.bit_length() + 127)) // d
+    return q >> (q.bit_length() - 128)
+
+
+def main():
+    print(HEADER)
+    print("#define PARSE_POW10_MIN         (%d)" % POW10_MIN)
+    print("#define PARSE_POW10_MAX         %d" % POW10_MAX)
+    print()
+    print("static const uint64_t PARSE_POW10"
+          "[PARSE_POW10_MAX - PARSE_POW10_MIN + 1][2] = {")
+    for e in range(POW10_MIN, POW10_MAX + 1):
+        m = mantissa(e)
+        print("    { 0x%016xull, 0x%016xull },   // 1e%d" %
+              (m & MASK64, m >> 64, e))
+    print("};")
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,99 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+// Byte-set span bodies, included by tokens.c once per SIMD variant.
+// No include guard on purpose. The includer defines:
+//   SETSPN_SUFFIX        name suffix (utils_setspn_<suffix> ...)
+//   SETSPN_W             bytes per vector
+//   SETSPN_V             vector type
+//   SETSPN_LOAD_A(p)     load from a SETSPN_W aligned address
+//   SETSPN_PREP(map)     declarations the next two need, built from map
+//   SETSPN_MEMBER(v)     uint64_t mask of the bytes of v in the set,
+//                        1 << SETSPN_SHIFT bits per byte
+//   SETSPN_ZERO(v)       the same for the NUL bytes
+//   SETSPN_SHIFT         log2 of the bits per byte in such a mask
+//
+// Like the string scanners, everything is read in aligned vectors.
+
+#define SETSPN_CAT2(a, b)   a##_##b
+#define SETSPN_CAT(a, b)    SETSPN_CAT2(a, b)
+#define SETSPN_FN(name)     SETSPN_CAT(name, SETSPN_SUFFIX)
+
+#define SETSPN_BITS         (1u << SETSPN_SHIFT)
+#define SETSPN_BELOW(n)     ((n) * SETSPN_BITS >= 64 ? ~0ull :              \
+                             (1ull << ((n) * SETSPN_BITS)) - 1)
+#define SETSPN_FIRST(m)     ((size_t)__builtin_ctzll(m) >> SETSPN_SHIFT)
+#define SETSPN_ALIGN(p)     ((const uint8_t*)((uintptr_t)(p) &                \
+                                              ~(uintptr_t)(SETSPN_W - 1)))
+// Bytes that end the span: members when looking for one, others otherwise
+#define SETSPN_STOP(v)      (SETSPN_MEMBER(v) ^ flip)
+
+ECLIB_SCAN
+size_t SETSPN_FN(utils_setspn)(const char* s, const uint8_t* map, int in) {
+    SETSPN_PREP(map);
+    const uint64_t flip = in ? SETSPN_BELOW(SETSPN_W) : 0;
+    const uint8_t* p = SETSPN_ALIGN(s);
+    size_t skip = (size_t)((const uint8_t*)s - p);
+
+    SETSPN_V v = SETSPN_LOAD_A(p);
+    uint64_t m = (SETSPN_STOP(v) | SETSPN_ZERO(v)) >> (skip * SETSPN_BITS);
+    if (m) return SETSPN_FIRST(m);
+    for (;;) {
+        p += SETSPN_W;
+        v = SETSPN_LOAD_A(p);
+        m = SETSPN_STOP(v) | SETSPN_ZERO(v);
+        if (m) return (size_t)(p - (const uint8_t*)s) + SETSPN_FIRST(m);
+    }
+}
+
+ECLIB_SCAN
+size_t SETSPN_FN(utils_setspn_mem)(const void* s, size_t n, const uint8_t* map,
+                                   int in) {
+    if (n == 0) return 0;
+
+    SETSPN_PREP(map);
+    const uint64_t flip = in ? SETSPN_BELOW(SETSPN_W) : 0;
+    const uint8_t* start = s;
+    const uint8_t* p = SETSPN_ALIGN(start);
+    size_t skip = (size_t)(start - p);
+    size_t avail = SETSPN_W - skip;
+
+    uint64_t m = SETSPN_STOP(SETSPN_LOAD_A(p)) >> (skip * SETSPN_BITS);
+    if (n <= avail) {
+        m &= SETSPN_BELOW(n);
+        return m ? SETSPN_FIRST(m) : n;
+    }
+    if (m) return SETSPN_FIRST(m);
+
+    size_t left = n - avail;
+    for (p += SETSPN_W; left > SETSPN_W; p += SETSPN_W, left -= SETSPN_W) {
+        m = SETSPN_STOP(SETSPN_LOAD_A(p));
+        if (m) return (size_t)(p - start) + SETSPN_FIRST(m);
+    }
+    m = SETSPN_STOP(SETSPN_LOAD_A(p)) & SETSPN_BELOW(left);
+    return m ? (size_t)(p - start) + SETSPN_FIRST(m) : n;
+}
+
+#undef SETSPN_CAT2
+#undef SETSPN_CAT
+#undef SETSPN_FN
+#undef SETSPN_BITS
+#undef SETSPN_BELOW
+#undef SETSPN_FIRST
+#undef SETSPN_ALIGN
+#undef SETSPN_STOP
+#undef SETSPN_SUFFIX
+#undef SETSPN_W
+#undef SETSPN_V
+#undef SETSPN_LOAD_A
+#undef SETSPN_PREP
+#undef SETSPN_MEMBER
+#undef SETSPN_ZERO
+#undef SETSPN_SHIFT
@@ -0,0 +1,116 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "utils_internal.h"
+
+// String and memory scanning
+// --------------------------
+// strops_impl.h instantiated per vector width. Every kernel boils down
+// to "which bytes of this vector equal that one" as a bit mask; only how
+// that mask is built differs between the variants.
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "the scanning kernels assume byte 0 sits in the low bits of a word"
+#endif
+
+#define SWAR_LOW7   0x7F7F7F7F7F7F7F7Full
+#define SWAR_ONES   0x0101010101010101ull
+
+// 0x80 in every byte of a ^ b that is zero, exact (no false positives
+// from borrows, so the highest match can be trusted as well)
+static inline uint64_t swar_eq(uint64_t a, uint64_t b) {
+    uint64_t x = a ^ b;
+    return ~(((x & SWAR_LOW7) + SWAR_LOW7) | x | SWAR_LOW7);
+}
+
+static inline uint64_t swar_ne(uint64_t a, uint64_t b) {
+    uint64_t x = a ^ b;
+    return (((x & SWAR_LOW7) + SWAR_LOW7) | x) & ~SWAR_LOW7;
+}
+
+// n < 32, for the tail of eclib_memcmp when there is no whole vector
+static inline int memcmp_small(const uint8_t* a, const uint8_t* b, size_t n) {
+    for (; n >= 8; a += 8, b += 8, n -= 8) {
+        uint64_t x = *(const utils_u64*)a ^ *(const utils_u64*)b;
+        if (x) {
+            size_t i = (size_t)__builtin_ctzll(x) >> 3;
+            return a[i] - b[i];
+        }
+    }
+    for (; n; a++, b++, n--) {
+        if (*a != *b) return *a - *b;
+    }
+    return 0;
+}
+
+// Portable: a 64-bit word at a time
+#define STROPS_SUFFIX       generic
+#define STROPS_W            8
+#define STROPS_V            uint64_t
+#define STROPS_LOAD_A(p)    (*(const utils_u64a*)(p))
+#define STROPS_LOAD_U(p)    (*(const utils_u64*)(p))
+#define STROPS_SPLAT(c)     (SWAR_ONES * (uint8_t)(c))
+#define STROPS_EQ(a, b)     swar_eq(a, b)
+#define STROPS_NE(a, b)     swar_ne(a, b)
+#define STROPS_SHIFT        3
+#include "strops_impl.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+#define STROPS_SUFFIX       sse2
+#define STROPS_W            16
+#define STROPS_V            vec16_a
+#define STROPS_LOAD_A(p)    (*(const vec16_a*)(p))
+#define STROPS_LOAD_U(p)    (*(const vec16_u*)(p))
+#define STROPS_SPLAT(c)     ((vec16_a){0} + (uint8_t)(c))
+#define STROPS_EQ(a, b)     \
+    ((uint64_t)(uint32_t)_mm_movemask_epi8((__m128i)((a) == (b))))
+#define STROPS_NE(a, b)     (STROPS_EQ(a, b) ^ 0xFFFFu)
+#define STROPS_SHIFT        0
+#include "strops_impl.h"
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define STROPS_SUFFIX       avx2
+#define STROPS_W            32
+#define STROPS_V            vec32_a
+#define STROPS_LOAD_A(p)    (*(const vec32_a*)(p))
+#define STROPS_LOAD_U(p)    (*(const vec32_u*)(p))
+#define STROPS_SPLAT(c)     ((vec32_a){0} + (uint8_t)(c))
+#define STROPS_EQ(a, b)     \
+    ((uint64_t)(uint32_t)_mm256_movemask_epi8((__m256i)((a) == (b))))
+#define STROPS_NE(a, b)     (STROPS_EQ(a, b) ^ 0xFFFFFFFFu)
+#define STROPS_SHIFT        0
+#include "strops_impl.h"
+#pragma GCC pop_options
+
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+
+// No movemask on NEON: narrowing the 0x00/0xFF compare result by 4 bits
+// per lane leaves a 64-bit mask with a nibble per byte.
+static inline uint64_t neon_mask(uint8x16_t eq) {
+    uint8x8_t nib = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nib), 0);
+}
+
+#define STROPS_SUFFIX       neon
+#define STROPS_W            16
+#define STROPS_V            vec16_a
+#define STROPS_LOAD_A(p)    (*(const vec16_a*)(p))
+#define STROPS_LOAD_U(p)    (*(const vec16_u*)(p))
+#define STROPS_SPLAT(c)     ((vec16_a){0} + (uint8_t)(c))
+#define STROPS_EQ(a, b)     neon_mask((uint8x16_t)((a) == (b)))
+#define STROPS_NE(a, b)     (~STROPS_EQ(a, b))
+#define STROPS_SHIFT        2
+#include "strops_impl.h"
+
+#endif
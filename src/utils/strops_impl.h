@@ -0,0 +1,258 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+// String scanning bodies, included by strops.c once per vector width.
+// No include guard on purpose. The includer defines:
+//   STROPS_SUFFIX        name suffix (utils_strlen_<suffix> ...)
+//   STROPS_W             bytes per vector
+//   STROPS_V             aligned vector type
+//   STROPS_LOAD_A(p)     load from a STROPS_W aligned address
+//   STROPS_LOAD_U(p)     load from any address
+//   STROPS_SPLAT(c)      vector with every byte set to c
+//   STROPS_EQ(a, b)      uint64_t mask of the equal bytes, 1 << STROPS_SHIFT
+//                        bits per byte, byte 0 in the lowest bits
+//   STROPS_NE(a, b)      the same for the bytes that differ
+//   STROPS_SHIFT         log2 of the bits per byte in such a mask
+//
+// Strings of unknown length are scanned in aligned vectors, so a read
+// past the terminator never leaves the page the terminator is on.
+
+#define STROPS_CAT2(a, b)   a##_##b
+#define STROPS_CAT(a, b)    STROPS_CAT2(a, b)
+#define STROPS_FN(name)     STROPS_CAT(name, STROPS_SUFFIX)
+
+#define STROPS_BITS         (1u << STROPS_SHIFT)
+// Mask of the first n bytes of a vector, n <= STROPS_W
+#define STROPS_BELOW(n)     ((n) * STROPS_BITS >= 64 ? ~0ull :              \
+                             (1ull << ((n) * STROPS_BITS)) - 1)
+#define STROPS_FIRST(m)     ((size_t)__builtin_ctzll(m) >> STROPS_SHIFT)
+#define STROPS_LAST(m)      ((size_t)(63 - __builtin_clzll(m)) >> STROPS_SHIFT)
+#define STROPS_ALIGN(p)     ((const uint8_t*)((uintptr_t)(p) &                \
+                                              ~(uintptr_t)(STROPS_W - 1)))
+// Whether an unaligned vector load at p stays inside p's page
+#define STROPS_PAGE_OK(p)   (((uintptr_t)(p) & (UTILS_PAGE_SIZE - 1)) <=    \
+                             UTILS_PAGE_SIZE - STROPS_W)
+
+ECLIB_SCAN
+size_t STROPS_FN(utils_strlen)(const char* s) {
+    const STROPS_V zero = STROPS_SPLAT(0);
+    const uint8_t* p = STROPS_ALIGN(s);
+    size_t skip = (size_t)((const uint8_t*)s - p);
+
+    uint64_t m = STROPS_EQ(STROPS_LOAD_A(p), zero) >> (skip * STROPS_BITS);
+    if (m) return STROPS_FIRST(m);
+    for (;;) {
+        p += STROPS_W;
+        m = STROPS_EQ(STROPS_LOAD_A(p), zero);
+        if (m) return (size_t)(p - (const uint8_t*)s) + STROPS_FIRST(m);
+    }
+}
+
+ECLIB_SCAN
+void* STROPS_FN(utils_memchr)(const void* s, int c, size_t n) {
+    if (n == 0) return NULL;
+
+    const STROPS_V vc = STROPS_SPLAT((uint8_t)c);
+    const uint8_t* start = s;
+    const uint8_t* p = STROPS_ALIGN(start);
+    size_t skip = (size_t)(start - p);
+    size_t avail = STROPS_W - skip;
+
+    uint64_t m = STROPS_EQ(STROPS_LOAD_A(p), vc) >> (skip * STROPS_BITS);
+    if (n <= avail) {
+        m &= STROPS_BELOW(n);
+        return m ? (void*)(start + STROPS_FIRST(m)) : NULL;
+    }
+    if (m) return (void*)(start + STROPS_FIRST(m));
+
+    size_t left = n - avail;
+    for (p += STROPS_W; left > STROPS_W; p += STROPS_W, left -= STROPS_W) {
+        m = STROPS_EQ(STROPS_LOAD_A(p), vc);
+        if (m) return (void*)(p + STROPS_FIRST(m));
+    }
+    m = STROPS_EQ(STROPS_LOAD_A(p), vc) & STROPS_BELOW(left);
+    return m ? (void*)(p + STROPS_FIRST(m)) : NULL;
+}
+
+ECLIB_SCAN
+void* STROPS_FN(utils_memrchr)(const void* s, int c, size_t n) {
+    if (n == 0) return NULL;
+
+    const STROPS_V vc = STROPS_SPLAT((uint8_t)c);
+    uintptr_t start = (uintptr_t)s;
+    const uint8_t* p = STROPS_ALIGN(start + n - 1);
+
+    // Bytes at and above the end do not count
+    uint64_t m = STROPS_EQ(STROPS_LOAD_A(p), vc) &
+                 STROPS_BELOW(start + n - (uintptr_t)p);
+    for (;;) {
+        if ((uintptr_t)p <= start) {
+            m &= ~STROPS_BELOW(start - (uintptr_t)p);
+            return m ? (void*)(p + STROPS_LAST(m)) : NULL;
+        }
+        if (m) return (void*)(p + STROPS_LAST(m));
+        p -= STROPS_W;
+        m = STROPS_EQ(STROPS_LOAD_A(p), vc);
+    }
+}
+
+ECLIB_SCAN
+size_t STROPS_FN(utils_strnlen)(const char* s, size_t n) {
+    const char* end = STROPS_FN(utils_memchr)(s, 0, n);
+    return end ? (size_t)(end - s) : n;
+}
+
+ECLIB_SCAN
+char* STROPS_FN(utils_strchr)(const char* s, int c) {
+    if ((uint8_t)c == 0) return (char*)s + STROPS_FN(utils_strlen)(s);
+
+    const STROPS_V vc = STROPS_SPLAT((uint8_t)c);
+    const STROPS_V zero = STROPS_SPLAT(0);
+    const uint8_t* p = STROPS_ALIGN(s);
+    size_t skip = (size_t)((const uint8_t*)s - p);
+
+    STROPS_V v = STROPS_LOAD_A(p);
+    uint64_t m = (STROPS_EQ(v, vc) | STROPS_EQ(v, zero)) >> (skip * STROPS_BITS);
+    if (m == 0) {
+        do {
+            p += STROPS_W;
+            v = STROPS_LOAD_A(p);
+            m = STROPS_EQ(v, vc) | STROPS_EQ(v, zero);
+        } while (m == 0);
+        skip = 0;
+    }
+    const uint8_t* hit = p + skip + STROPS_FIRST(m);
+    return *hit ? (char*)hit : NULL;
+}
+
+ECLIB_SCAN
+char* STROPS_FN(utils_strrchr)(const char* s, int c) {
+    if ((uint8_t)c == 0) return (char*)s + STROPS_FN(utils_strlen)(s);
+
+    const STROPS_V vc = STROPS_SPLAT((uint8_t)c);
+    const STROPS_V zero = STROPS_SPLAT(0);
+    const uint8_t* p = STROPS_ALIGN(s);
+    uint64_t valid = ~STROPS_BELOW((size_t)((const uint8_t*)s - p));
+    const uint8_t* last = NULL;
+    uint64_t last_m = 0;
+
+    for (;;) {
+        STROPS_V v = STROPS_LOAD_A(p);
+        uint64_t e = STROPS_EQ(v, vc) & valid;
+        uint64_t z = STROPS_EQ(v, zero) & valid;
+        if (z) {
+            // Matches up to the terminator only
+            e &= z ^ (z - 1);
+            if (e) return (char*)(p + STROPS_LAST(e));
+            return last ? (char*)(last + STROPS_LAST(last_m)) : NULL;
+        }
+        if (e) {
+            last = p;
+            last_m = e;
+        }
+        p += STROPS_W;
+        valid = ~0ull;
+    }
+}
+
+ECLIB_SCAN
+int STROPS_FN(utils_strcmp)(const char* s1, const char* s2) {
+    const STROPS_V zero = STROPS_SPLAT(0);
+    const uint8_t* a = (const uint8_t*)s1;
+    const uint8_t* b = (const uint8_t*)s2;
+
+    for (;;) {
+        if (STROPS_PAGE_OK(a) && STROPS_PAGE_OK(b)) {
+            STROPS_V va = STROPS_LOAD_U(a);
+            STROPS_V vb = STROPS_LOAD_U(b);
+            uint64_t m = STROPS_NE(va, vb) | STROPS_EQ(va, zero);
+            if (m) {
+                size_t i = STROPS_FIRST(m);
+                return a[i] - b[i];
+            }
+            a += STROPS_W;
+            b += STROPS_W;
+        } else {
+            // One byte at a time until neither load would cross a page
+            if (*a != *b || *a == 0) return *a - *b;
+            a++;
+            b++;
+        }
+    }
+}
+
+ECLIB_SCAN
+int STROPS_FN(utils_strncmp)(const char* s1, const char* s2, size_t n) {
+    const STROPS_V zero = STROPS_SPLAT(0);
+    const uint8_t* a = (const uint8_t*)s1;
+    const uint8_t* b = (const uint8_t*)s2;
+
+    while (n) {
+        if (STROPS_PAGE_OK(a) && STROPS_PAGE_OK(b)) {
+            STROPS_V va = STROPS_LOAD_U(a);
+            STROPS_V vb = STROPS_LOAD_U(b);
+            uint64_t m = STROPS_NE(va, vb) | STROPS_EQ(va, zero);
+            if (n < STROPS_W) m &= STROPS_BELOW(n);
+            if (m) {
+                size_t i = STROPS_FIRST(m);
+                return a[i] - b[i];
+            }
+            if (n <= STROPS_W) return 0;
+            a += STROPS_W;
+            b += STROPS_W;
+            n -= STROPS_W;
+        } else {
+            if (*a != *b || *a == 0) return *a - *b;
+            a++;
+            b++;
+            n--;
+        }
+    }
+    return 0;
+}
+
+int STROPS_FN(utils_memcmp)(const void* s1, const void* s2, size_t n) {
+    const uint8_t* a = s1;
+    const uint8_t* b = s2;
+    if (n < STROPS_W) return memcmp_small(a, b, n);
+
+    // Whole vectors, then one more ending at the last byte; the overlap
+    // with the previous vector is known to be equal.
+    size_t off = 0;
+    for (;;) {
+        uint64_t m = STROPS_NE(STROPS_LOAD_U(a + off), STROPS_LOAD_U(b + off));
+        if (m) {
+            size_t i = off + STROPS_FIRST(m);
+            return a[i] - b[i];
+        }
+        if (off + STROPS_W == n) return 0;
+        off += STROPS_W;
+        if (n - off < STROPS_W) off = n - STROPS_W;
+    }
+}
+
+#undef STROPS_CAT2
+#undef STROPS_CAT
+#undef STROPS_FN
+#undef STROPS_BITS
+#undef STROPS_BELOW
+#undef STROPS_FIRST
+#undef STROPS_LAST
+#undef STROPS_ALIGN
+#undef STROPS_PAGE_OK
+#undef STROPS_SUFFIX
+#undef STROPS_W
+#undef STROPS_V
+#undef STROPS_LOAD_A
+#undef STROPS_LOAD_U
+#undef STROPS_SPLAT
+#undef STROPS_EQ
+#undef STROPS_NE
+#undef STROPS_SHIFT
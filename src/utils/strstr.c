@@ -0,0 +1,203 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/utils.h"
+#include "utils_internal.h"
+
+// Substring search
+// ----------------
+// Needles of up to NEEDLE_SHORT bytes: let the vector memchr/strchr find
+// candidates for the first byte and compare the rest in place, which is
+// linear since the needle length is bounded. Longer needles use the
+// Crochemore-Perrin Two-Way algorithm: linear time, constant space, plus a
+// last-byte shift table so typical text is skipped a whole needle at a
+// time. strstr never measures the haystack; it only looks ahead as far as
+// the window needs, in memchr-sized steps.
+
+#define NEEDLE_SHORT    8
+
+// Maximal suffix of n[0..len) under one of the two byte orders. Returns
+// the start of the suffix minus one (may be SIZE_MAX) and its period.
+static size_t maximal_suffix(const uint8_t* n, size_t len, int reverse,
+                             size_t* period) {
+    size_t ip = SIZE_MAX;       // candidate suffix starts at ip + 1
+    size_t jp = 0;
+    size_t k = 1, p = 1;
+
+    while (jp + k < len) {
+        uint8_t a = n[ip + k], b = n[jp + k];
+        if (a == b) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (reverse ? a < b : a > b) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    *period = p;
+    return ip;
+}
+
+void eclib_needle_init(eclib_needle_t* nd, const void* needle, size_t len) {
+    const uint8_t* n = needle;
+    nd->needle = n;
+    nd->len = len;
+
+    for (unsigned c = 0; c < 256; c++) {
+        nd->skip[c] = len;
+    }
+    for (size_t i = 0; i + 1 < len; i++) {
+        nd->skip[n[i]] = len - 1 - i;
+    }
+    if (len) nd->skip[n[len - 1]] = 0;
+
+    // Critical factorisation: the later of the two maximal suffixes
+    size_t p0, p1;
+    size_t ms0 = maximal_suffix(n, len, 0, &p0);
+    size_t ms1 = maximal_suffix(n, len, 1, &p1);
+    size_t ms = ms1 + 1 > ms0 + 1 ? ms1 : ms0;
+    size_t p = ms1 + 1 > ms0 + 1 ? p1 : p0;
+
+    if (len && ms + 1 + p <= len && eclib_memcmp(n, n + p, ms + 1) == 0) {
+        // The left part repeats with the period: after a period shift the
+        // first len - p bytes are already known to match.
+        nd->mem0 = len - p;
+    } else {
+        size_t right = len - ms - 1;
+        nd->mem0 = 0;
+        p = (ms + 1 > right ? ms + 1 : right) + 1;
+    }
+    nd->ms = ms;
+    nd->period = p;
+}
+
+// Two-Way over h. With bounded set, end is the end of the haystack;
+// otherwise it is how far the haystack is known to have no terminator.
+static inline __attribute__((always_inline))
+const uint8_t* twoway(const eclib_needle_t* nd, const uint8_t* h,
+                      const uint8_t* end, int bounded) {
+    const uint8_t* n = nd->needle;
+    size_t len = nd->len;
+    size_t ms = nd->ms;
+    size_t mem = 0;
+
+    for (;;) {
+        if ((size_t)(end - h) < len) {
+            if (bounded) return NULL;
+            size_t grow = len | 63;
+            const uint8_t* z = eclib_memchr(end, 0, grow);
+            if (z) {
+                end = z;
+                if ((size_t)(end - h) < len) return NULL;
+                bounded = 1;
+            } else {
+                end += grow;
+            }
+        }
+
+        // Last byte of the window first
+        size_t k = nd->skip[h[len - 1]];
+        if (k) {
+            h += k < mem ? mem : k;
+            mem = 0;
+            continue;
+        }
+
+        // Right half, then left half
+        k = ms + 1 > mem ? ms + 1 : mem;
+        while (k < len && n[k] == h[k]) k++;
+        if (k < len) {
+            h += k - ms;
+            mem = 0;
+            continue;
+        }
+        k = ms + 1;
+        while (k > mem && n[k - 1] == h[k - 1]) k--;
+        if (k <= mem) return h;
+
+        h += nd->period;
+        mem = nd->mem0;
+    }
+}
+
+const void* eclib_needle_find(const eclib_needle_t* nd, const void* hay,
+                              size_t hay_len) {
+    if (nd == NULL || hay == NULL) return NULL;
+    if (nd->len == 0) return hay;
+    const uint8_t* h = hay;
+    return twoway(nd, h, h + hay_len, 1);
+}
+
+const char* eclib_needle_find_str(const eclib_needle_t* nd, const char* str) {
+    if (nd == NULL || str == NULL) return NULL;
+    if (nd->len == 0) return str;
+    const uint8_t* h = (const uint8_t*)str;
+    return (const char*)twoway(nd, h, h, 0);
+}
+
+void* eclib_memmem(const void* hay, size_t hay_len,
+                   const void* needle, size_t len) {
+    if (hay == NULL || needle == NULL) return NULL;
+    if (len == 0) return (void*)hay;
+    if (len > hay_len) return NULL;
+
+    const uint8_t* n = needle;
+    const uint8_t* h = eclib_memchr(hay, n[0], hay_len - len + 1);
+    if (h == NULL || len == 1) return (void*)h;
+    const uint8_t* end = (const uint8_t*)hay + hay_len;
+
+    if (len <= NEEDLE_SHORT) {
+        for (;;) {
+            if (eclib_memcmp(h + 1, n + 1, len - 1) == 0) return (void*)h;
+            h++;
+            h = eclib_memchr(h, n[0], (size_t)(end - h) - len + 1);
+            if (h == NULL) return NULL;
+        }
+    }
+
+    eclib_needle_t nd;
+    eclib_needle_init(&nd, needle, len);
+    return (void*)twoway(&nd, h, end, 1);
+}
+
+const char* eclib_strstr(const char* str, const char* substr) {
+    if (str == NULL || substr == NULL || *substr == '\0') {
+        return NULL;
+    }
+
+    const char* h = eclib_strchr(str, *substr);
+    if (h == NULL || substr[1] == '\0') return h;
+
+    // Short needle: compare in place until the needle or the haystack ends
+    size_t len = eclib_strnlen(substr, NEEDLE_SHORT + 1);
+    if (len <= NEEDLE_SHORT) {
+        for (;;) {
+            size_t i = 1;
+            while (i < len && h[i] == substr[i]) i++;
+            if (i == len) return h;
+            if (h[i] == '\0') return NULL;
+            h = eclib_strchr(h + 1, *substr);
+            if (h == NULL) return NULL;
+        }
+    }
+
+    eclib_needle_t nd;
+    eclib_needle_init(&nd, substr, eclib_strlen(substr));
+    const uint8_t* hu = (const uint8_t*)h;
+    return (const char*)twoway(&nd, hu, hu, 0);
+}
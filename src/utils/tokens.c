@@ -0,0 +1,242 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/utils.h"
+#include "utils_internal.h"
+
+// Tokenizing
+// ----------
+// Delimiters are an eclib_charset_t: 256 bits indexed by the low nibble
+// of a byte and its top bit, with bits 4-6 picking the bit. A scalar
+// lookup is one load and a shift, and a vector byte shuffle classifies a
+// whole block at once (16 bytes on NEON, 32 with AVX2). Plain SSE2 has
+// no byte shuffle, so it shares the portable loop.
+
+// --------------------------
+// Span kernels
+// --------------------------
+static inline int set_has(const uint8_t* map, uint8_t c) {
+    return (map[(c >> 7) * 16 + (c & 15)] >> ((c >> 4) & 7)) & 1;
+}
+
+size_t utils_setspn_generic(const char* s, const uint8_t* map, int in) {
+    const uint8_t* p = (const uint8_t*)s;
+    if (in) {
+        while (*p && set_has(map, *p)) p++;
+    } else {
+        while (*p && !set_has(map, *p)) p++;
+    }
+    return (size_t)(p - (const uint8_t*)s);
+}
+
+size_t utils_setspn_mem_generic(const void* s, size_t n, const uint8_t* map,
+                                int in) {
+    const uint8_t* p = s;
+    size_t i = 0;
+    if (in) {
+        while (i < n && set_has(map, p[i])) i++;
+    } else {
+        while (i < n && !set_has(map, p[i])) i++;
+    }
+    return i;
+}
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+static inline uint64_t member_avx2(__m256i v, __m256i lo, __m256i hi,
+                                   __m256i sel) {
+    // pshufb yields 0 for bytes with the top bit set, so each table only
+    // answers for its half of the byte values
+    __m256i t = _mm256_or_si256(
+        _mm256_shuffle_epi8(lo, v),
+        _mm256_shuffle_epi8(hi, _mm256_xor_si256(v, _mm256_set1_epi8((char)0x80))));
+    __m256i nib = _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+    __m256i bit = _mm256_shuffle_epi8(sel, nib);
+    __m256i none = _mm256_cmpeq_epi8(_mm256_and_si256(t, bit), _mm256_setzero_si256());
+    return (uint32_t)~_mm256_movemask_epi8(none);
+}
+
+#define SETSPN_SUFFIX       avx2
+#define SETSPN_W            32
+#define SETSPN_V            __m256i
+#define SETSPN_LOAD_A(p)    _mm256_load_si256((const __m256i*)(p))
+#define SETSPN_PREP(map)                                                    \
+    const __m256i lo = _mm256_broadcastsi128_si256(                         \
+        _mm_loadu_si128((const __m128i*)(map)));                            \
+    const __m256i hi = _mm256_broadcastsi128_si256(                         \
+        _mm_loadu_si128((const __m128i*)(map) + 1));                        \
+    const __m256i sel = _mm256_broadcastsi128_si256(                        \
+        _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)128,                    \
+                      1, 2, 4, 8, 16, 32, 64, (char)128))
+#define SETSPN_MEMBER(v)    member_avx2(v, lo, hi, sel)
+#define SETSPN_ZERO(v)      ((uint64_t)(uint32_t)_mm256_movemask_epi8(      \
+                                 _mm256_cmpeq_epi8(v, _mm256_setzero_si256())))
+#define SETSPN_SHIFT        0
+#include "setspn_impl.h"
+#pragma GCC pop_options
+
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+
+// Nibble per byte, as in strops.c
+static inline uint64_t setspn_neon_mask(uint8x16_t m) {
+    uint8x8_t nib = vshrn_n_u16(vreinterpretq_u16_u8(m), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nib), 0);
+}
+
+static inline uint64_t member_neon(uint8x16_t v, uint8x16x2_t tab,
+                                   uint8x16_t sel) {
+    // TBL gives 0 for out of range indexes, so fold the top bit into
+    // bit 4 and look up the whole 32-byte map at once
+    uint8x16_t idx = vorrq_u8(vandq_u8(v, vdupq_n_u8(0x0F)),
+                              vandq_u8(vshrq_n_u8(v, 3), vdupq_n_u8(0x10)));
+    uint8x16_t t = vqtbl2q_u8(tab, idx);
+    uint8x16_t bit = vqtbl1q_u8(sel, vshrq_n_u8(v, 4));
+    return setspn_neon_mask(vtstq_u8(t, bit));
+}
+
+#define SETSPN_SUFFIX       neon
+#define SETSPN_W            16
+#define SETSPN_V            uint8x16_t
+#define SETSPN_LOAD_A(p)    vld1q_u8(p)
+#define SETSPN_PREP(map)                                                    \
+    const uint8x16x2_t tab = { { vld1q_u8(map), vld1q_u8((map) + 16) } };   \
+    static const uint8_t sel_bytes[16] = {                                  \
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };         \
+    const uint8x16_t sel = vld1q_u8(sel_bytes)
+#define SETSPN_MEMBER(v)    member_neon(v, tab, sel)
+#define SETSPN_ZERO(v)      setspn_neon_mask(vceqq_u8(v, vdupq_n_u8(0)))
+#define SETSPN_SHIFT        2
+#include "setspn_impl.h"
+
+#endif
+
+// --------------------------
+// Charsets
+// --------------------------
+void eclib_charset_init(eclib_charset_t* set, const char* chars, size_t n) {
+    if (set == NULL) return;
+    for (int i = 0; i < 32; i++) set->map[i] = 0;
+    for (size_t i = 0; chars && i < n; i++) {
+        eclib_charset_add(set, (unsigned char)chars[i]);
+    }
+}
+
+void eclib_charset_add(eclib_charset_t* set, unsigned char c) {
+    set->map[(c >> 7) * 16 + (c & 15)] |= (uint8_t)(1u << ((c >> 4) & 7));
+}
+
+int eclib_charset_has(const eclib_charset_t* set, unsigned char c) {
+    return set_has(set->map, c);
+}
+
+size_t eclib_strspn(const char* s, const char* accept) {
+    if (s == NULL || accept == NULL) return 0;
+    eclib_charset_t set;
+    eclib_charset_init(&set, accept, eclib_strlen(accept));
+    return g_utils_ops.setspn(s, set.map, 1);
+}
+
+size_t eclib_strcspn(const char* s, const char* reject) {
+    if (s == NULL) return 0;
+    eclib_charset_t set;
+    eclib_charset_init(&set, reject, eclib_strlen(reject));
+    return g_utils_ops.setspn(s, set.map, 0);
+}
+
+// --------------------------
+// strtok
+// --------------------------
+char* eclib_strtok_set(char* str, const eclib_charset_t* delims, char** save) {
+    if (delims == NULL || save == NULL) return NULL;
+    char* s = str ? str : *save;
+    if (s == NULL) return NULL;
+
+    s += g_utils_ops.setspn(s, delims->map, 1);
+    if (*s == '\0') {
+        *save = s;
+        return NULL;
+    }
+    char* end = s + g_utils_ops.setspn(s, delims->map, 0);
+    if (*end) *end++ = '\0';
+    *save = end;
+    return s;
+}
+
+char* eclib_strtok_r(char* str, const char* delim, char** save) {
+    if (delim == NULL) return NULL;
+    eclib_charset_t set;
+    eclib_charset_init(&set, delim, eclib_strlen(delim));
+    return eclib_strtok_set(str, &set, save);
+}
+
+// One position per thread, so concurrent callers at least do not
+// corrupt each other; eclib_strtok_r is still the one to use.
+static __thread char* t_strtok_state;
+
+char* eclib_strtok(char* str, const char* delim) {
+    return eclib_strtok_r(str, delim, &t_strtok_state);
+}
+
+// --------------------------
+// Views
+// --------------------------
+void eclib_tokenizer_init(eclib_tokenizer_t* tok, const void* data, size_t len,
+                          const eclib_charset_t* delims) {
+    if (tok == NULL) return;
+    tok->pos = data;
+    tok->end = data ? (const char*)data + len : NULL;
+    tok->delims = delims;
+}
+
+int eclib_tokenizer_next(eclib_tokenizer_t* tok, eclib_strview_t* out) {
+    if (tok == NULL || out == NULL || tok->pos == NULL) return 0;
+    const uint8_t* map = tok->delims->map;
+
+    tok->pos += g_utils_ops.setspn_mem(tok->pos, (size_t)(tok->end - tok->pos),
+                                       map, 1);
+    if (tok->pos == tok->end) return 0;
+
+    size_t n = g_utils_ops.setspn_mem(tok->pos, (size_t)(tok->end - tok->pos),
+                                      map, 0);
+    out->ptr = tok->pos;
+    out->len = n;
+    tok->pos += n;
+    return 1;
+}
+
+int eclib_tokenizer_field(eclib_tokenizer_t* tok, eclib_strview_t* out) {
+    if (tok == NULL || out == NULL || tok->pos == NULL) return 0;
+    if (tok->pos == tok->end) return 0;
+
+    size_t left = (size_t)(tok->end - tok->pos);
+    size_t n = g_utils_ops.setspn_mem(tok->pos, left, tok->delims->map, 0);
+    out->ptr = tok->pos;
+    out->len = n;
+    tok->pos = n < left ? tok->pos + n + 1 : tok->end;
+    return 1;
+}
+
+int eclib_strview_split(eclib_strview_t sv, char sep,
+                        eclib_strview_t* head, eclib_strview_t* tail) {
+    const char* at = sv.ptr ? eclib_memchr(sv.ptr, sep, sv.len) : NULL;
+    eclib_strview_t h = sv, t = { sv.ptr ? sv.ptr + sv.len : NULL, 0 };
+    if (at) {
+        h.len = (size_t)(at - sv.ptr);
+        t.ptr = at + 1;
+        t.len = sv.len - h.len - 1;
+    }
+    if (head) *head = h;
+    if (tail) *tail = t;
+    return at != NULL;
+}
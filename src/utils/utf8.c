@@ -0,0 +1,547 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+#include "eclib/utils.h"
+#include "eclib/error.h"
+#include "utils_internal.h"
+
+// UTF-8
+// -----
+// Text is mostly ASCII with runs of CJK in between, so every routine
+// first tries 16 bytes at a time for ASCII and only decodes one sequence
+// at a time when that fails. Validation has vector kernels for non-ASCII
+// as well (AVX2, NEON): the lookup method of Keiser and Lemire, which
+// classifies each byte pair with three nibble table lookups.
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "the ASCII masks assume little-endian words"
+#endif
+
+#define ASCII_MASK8     0x8080808080808080ull
+#define ASCII_MASK16    0xFF80FF80FF80FF80ull
+
+typedef int8_t s8x16_u __attribute__((vector_size(16), aligned(1), may_alias));
+typedef uint16_t u16x16 __attribute__((vector_size(32)));
+typedef uint16_t u16x16_u __attribute__((vector_size(32), aligned(1), may_alias));
+typedef uint16_t u16x8_u __attribute__((vector_size(16), aligned(1), may_alias));
+typedef uint8_t u8x4_u __attribute__((vector_size(4), aligned(1), may_alias));
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+typedef uint32_t u32x4_u __attribute__((vector_size(16), aligned(1), may_alias));
+typedef uint8_t u8x8 __attribute__((vector_size(8)));
+typedef uint8_t u8x8_u __attribute__((vector_size(8), aligned(1), may_alias));
+typedef uint64_t u64x2 __attribute__((vector_size(16)));
+
+static inline int utf8_cont(uint8_t c) {
+    return (c & 0xC0) == 0x80;
+}
+
+static inline int ascii16(const uint8_t* p) {
+    return ((*(const utils_u64*)p | *(const utils_u64*)(p + 8)) &
+            ASCII_MASK8) == 0;
+}
+
+// Number of ASCII bytes at the start of p[0..16)
+static inline size_t ascii_prefix16(const uint8_t* p) {
+    uint64_t lo = *(const utils_u64*)p & ASCII_MASK8;
+    uint64_t hi = *(const utils_u64*)(p + 8) & ASCII_MASK8;
+
+    if (lo) return (size_t)__builtin_ctzll(lo) >> 3;
+    if (hi) return 8 + ((size_t)__builtin_ctzll(hi) >> 3);
+    return 16;
+}
+
+// Decode the sequence at s, avail > 0 bytes.
+// Return: its length, 0 if it is invalid or cut off
+static inline size_t utf8_decode(const uint8_t* s, size_t avail,
+                                 uint32_t* cp) {
+    uint8_t c = s[0];
+    uint8_t lo = 0x80, hi = 0xBF;
+
+    if (c < 0x80) {
+        *cp = c;
+        return 1;
+    }
+    if (c < 0xC2) return 0;
+    if (c < 0xE0) {
+        if (avail < 2 || !utf8_cont(s[1])) return 0;
+        *cp = (uint32_t)(c & 0x1F) << 6 | (s[1] & 0x3F);
+        return 2;
+    }
+    if (c < 0xF0) {
+        if (c == 0xE0) lo = 0xA0;           // overlong
+        if (c == 0xED) hi = 0x9F;           // surrogates
+        if (avail < 3 || s[1] < lo || s[1] > hi || !utf8_cont(s[2])) {
+            return 0;
+        }
+        *cp = (uint32_t)(c & 0x0F) << 12 | (uint32_t)(s[1] & 0x3F) << 6 |
+              (s[2] & 0x3F);
+        return 3;
+    }
+    if (c < 0xF5) {
+        if (c == 0xF0) lo = 0x90;           // overlong
+        if (c == 0xF4) hi = 0x8F;           // above U+10FFFF
+        if (avail < 4 || s[1] < lo || s[1] > hi || !utf8_cont(s[2]) ||
+            !utf8_cont(s[3])) {
+            return 0;
+        }
+        *cp = (uint32_t)(c & 0x07) << 18 | (uint32_t)(s[1] & 0x3F) << 12 |
+              (uint32_t)(s[2] & 0x3F) << 6 | (s[3] & 0x3F);
+        return 4;
+    }
+    return 0;
+}
+
+static inline size_t utf8_width(uint32_t c) {
+    return 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000);
+}
+
+static inline void utf8_encode(uint8_t* d, uint32_t c) {
+    if (c < 0x80) {
+        d[0] = (uint8_t)c;
+    } else if (c < 0x800) {
+        d[0] = (uint8_t)(0xC0 | c >> 6);
+        d[1] = (uint8_t)(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        d[0] = (uint8_t)(0xE0 | c >> 12);
+        d[1] = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+        d[2] = (uint8_t)(0x80 | (c & 0x3F));
+    } else {
+        d[0] = (uint8_t)(0xF0 | c >> 18);
+        d[1] = (uint8_t)(0x80 | ((c >> 12) & 0x3F));
+        d[2] = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+        d[3] = (uint8_t)(0x80 | (c & 0x3F));
+    }
+}
+
+// --------------------------
+// Validation
+// --------------------------
+static size_t utf8_check_from(const uint8_t* s, size_t len, size_t i) {
+    uint32_t cp;
+
+    while (i < len) {
+        if (len - i >= 16 && ascii16(s + i)) {
+            i += 16;
+            continue;
+        }
+        if (s[i] < 0x80) {
+            i++;
+            continue;
+        }
+        size_t n = utf8_decode(s + i, len - i, &cp);
+        if (n == 0) return i;
+        i += n;
+    }
+    return len;
+}
+
+size_t utils_utf8_check_generic(const uint8_t* s, size_t len) {
+    return utf8_check_from(s, len, 0);
+}
+
+// The vector kernels only say that something in a block is wrong, and it
+// may be a sequence cut short by the block before. The scalar check that
+// finds out where restarts at the lead of the sequence holding byte i - 1:
+// everything before that lead has been checked, and the lead is at most
+// three bytes back since four continuations in a row never pass.
+static size_t utf8_back(const uint8_t* s, size_t i) {
+    size_t p = i;
+
+    if (p == 0) return 0;
+    p--;
+    while (p > 0 && i - 1 - p < 3 && utf8_cont(s[p])) p--;
+    return p;
+}
+
+// Error classes for a pair of bytes, one bit each. A pair is bad when
+// the classes of the first byte's high nibble, its low nibble and the
+// second byte's high nibble have a bit in common.
+#define TOO_SHORT       (1 << 0)    // lead followed by a lead or ASCII
+#define TOO_LONG        (1 << 1)    // ASCII followed by a continuation
+#define OVERLONG_3      (1 << 2)    // E0 80..9F
+#define TOO_LARGE       (1 << 3)    // F4 90..BF, F5..FF
+#define SURROGATE       (1 << 4)    // ED A0..BF
+#define OVERLONG_2      (1 << 5)    // C0..C1
+#define TOO_LARGE_1000  (1 << 6)    // F5..FF 80..8F
+#define OVERLONG_4      (1 << 6)    // F0 80..8F
+#define TWO_CONTS       (1 << 7)    // continuation after continuation,
+                                    // unless a 3/4-byte lead wants it
+#define CARRY           (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+#if defined(__x86_64__) || defined(__aarch64__)
+static const uint8_t UTF8_BYTE1_HIGH[16] = {
+    // 0___ ASCII
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    // 10__ continuation
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+    // 1100, 1101 two-byte lead
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    // 1110 three-byte lead
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    // 1111 four-byte lead
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+};
+
+static const uint8_t UTF8_BYTE1_LOW[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,       // ____0000
+    CARRY | OVERLONG_2,                                 // ____0001
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE,                                  // ____0100
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,     // ____1101
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+static const uint8_t UTF8_BYTE2_HIGH[16] = {
+    // 0___ ASCII
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    // 1000
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 |
+        OVERLONG_4,
+    // 1001
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    // 101_
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    // 11__ lead
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+};
+#endif
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+// The 32 bytes ending n before in
+#define AVX2_PREV(in, prev, n) \
+    _mm256_alignr_epi8(in, _mm256_permute2x128_si256(prev, in, 0x21), 16 - (n))
+
+static inline __m256i avx2_table(const uint8_t* t) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t));
+}
+
+size_t utils_utf8_check_avx2(const uint8_t* s, size_t len) {
+    const __m256i b1h = avx2_table(UTF8_BYTE1_HIGH);
+    const __m256i b1l = avx2_table(UTF8_BYTE1_LOW);
+    const __m256i b2h = avx2_table(UTF8_BYTE2_HIGH);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    // Leads in the last three bytes that need more than are left
+    const __m256i last_max = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)0xEF, (char)0xDF, (char)0xBF);
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; len - i >= 32; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i err;
+        if (_mm256_movemask_epi8(in) == 0) {
+            err = incomplete;
+            incomplete = _mm256_setzero_si256();
+        } else {
+            __m256i p1 = AVX2_PREV(in, prev, 1);
+            __m256i p2 = AVX2_PREV(in, prev, 2);
+            __m256i p3 = AVX2_PREV(in, prev, 3);
+            __m256i sc = _mm256_and_si256(
+                _mm256_and_si256(
+                    _mm256_shuffle_epi8(b1h, _mm256_and_si256(
+                        _mm256_srli_epi16(p1, 4), nibble)),
+                    _mm256_shuffle_epi8(b1l, _mm256_and_si256(p1, nibble))),
+                _mm256_shuffle_epi8(b2h, _mm256_and_si256(
+                    _mm256_srli_epi16(in, 4), nibble)));
+            // Third and fourth bytes of a sequence are the only places
+            // two continuations in a row are right
+            __m256i must23 = _mm256_or_si256(
+                _mm256_subs_epu8(p2, _mm256_set1_epi8(0xE0 - 0x80)),
+                _mm256_subs_epu8(p3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+            must23 = _mm256_and_si256(must23, _mm256_set1_epi8((char)0x80));
+            err = _mm256_xor_si256(must23, sc);
+            incomplete = _mm256_subs_epu8(in, last_max);
+        }
+        if (!_mm256_testz_si256(err, err)) break;
+        prev = in;
+    }
+    return utf8_check_from(s, len, utf8_back(s, i));
+}
+#pragma GCC pop_options
+
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+
+size_t utils_utf8_check_neon(const uint8_t* s, size_t len) {
+    const uint8x16_t b1h = vld1q_u8(UTF8_BYTE1_HIGH);
+    const uint8x16_t b1l = vld1q_u8(UTF8_BYTE1_LOW);
+    const uint8x16_t b2h = vld1q_u8(UTF8_BYTE2_HIGH);
+    const uint8x16_t nibble = vdupq_n_u8(0x0F);
+    static const uint8_t last_max_bytes[16] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+    };
+    const uint8x16_t last_max = vld1q_u8(last_max_bytes);
+    uint8x16_t prev = vdupq_n_u8(0);
+    uint8x16_t incomplete = vdupq_n_u8(0);
+    size_t i = 0;
+
+    for (; len - i >= 16; i += 16) {
+        uint8x16_t in = vld1q_u8(s + i);
+        uint8x16_t err;
+        if (vmaxvq_u8(in) < 0x80) {
+            err = incomplete;
+            incomplete = vdupq_n_u8(0);
+        } else {
+            uint8x16_t p1 = vextq_u8(prev, in, 15);
+            uint8x16_t p2 = vextq_u8(prev, in, 14);
+            uint8x16_t p3 = vextq_u8(prev, in, 13);
+            uint8x16_t sc = vandq_u8(
+                vandq_u8(vqtbl1q_u8(b1h, vshrq_n_u8(p1, 4)),
+                         vqtbl1q_u8(b1l, vandq_u8(p1, nibble))),
+                vqtbl1q_u8(b2h, vshrq_n_u8(in, 4)));
+            uint8x16_t must23 = vorrq_u8(
+                vqsubq_u8(p2, vdupq_n_u8(0xE0 - 0x80)),
+                vqsubq_u8(p3, vdupq_n_u8(0xF0 - 0x80)));
+            must23 = vandq_u8(must23, vdupq_n_u8(0x80));
+            err = veorq_u8(must23, sc);
+            incomplete = vqsubq_u8(in, last_max);
+        }
+        if (vmaxvq_u8(err) != 0) break;
+        prev = in;
+    }
+    return utf8_check_from(s, len, utf8_back(s, i));
+}
+#endif
+
+size_t eclib_utf8_check(const char* s, size_t len) {
+    if (s == NULL) return 0;
+    return g_utils_ops.utf8_check((const uint8_t*)s, len);
+}
+
+// --------------------------
+// Counting
+// --------------------------
+// Folds the 16 byte counters of acc
+static inline size_t sum_bytes(vec16_a acc) {
+    u64x2 w = (u64x2)acc;
+    size_t n = 0;
+
+    for (int k = 0; k < 2; k++) {
+        uint64_t x = w[k];
+        x = (x & 0x00FF00FF00FF00FFull) + ((x >> 8) & 0x00FF00FF00FF00FFull);
+        n += (size_t)((x * 0x0001000100010001ull) >> 48);
+    }
+    return n;
+}
+
+size_t eclib_utf8_count(const char* str, size_t len) {
+    const uint8_t* s = (const uint8_t*)str;
+    size_t n = 0, i = 0;
+
+    if (s == NULL) return 0;
+    // Per-byte counters hold 255 rounds before they must be folded
+    while (len - i >= 16) {
+        vec16_a acc = {0};
+        size_t rounds = (len - i) / 16;
+        if (rounds > 255) rounds = 255;
+        for (; rounds; rounds--, i += 16) {
+            // signed: 10xxxxxx is -128..-65
+            acc -= (vec16_a)(*(const s8x16_u*)(s + i) > -65);
+        }
+        n += sum_bytes(acc);
+    }
+    for (; i < len; i++) n += !utf8_cont(s[i]);
+    return n;
+}
+
+// --------------------------
+// Transcoding
+// --------------------------
+static eclib_err_t utf_result(eclib_err_t err, size_t o, size_t* out_len) {
+    *out_len = o;
+    if (err != ECLIB_OK) eclib_set_last_err(err);
+    return err;
+}
+
+#define UTF_CHECK_ARGS(s, len, out, cap, out_len)                          \
+    do {                                                                   \
+        if (((s) == NULL && (len)) || ((out) == NULL && (cap)) ||          \
+            (out_len) == NULL) {                                           \
+            eclib_set_last_err(ECLIB_ECLIB_INVALID_PARAMETER);             \
+            return ECLIB_ECLIB_INVALID_PARAMETER;                          \
+        }                                                                  \
+    } while (0)
+
+eclib_err_t eclib_utf8_to_utf16(const char* str, size_t len, uint16_t* out,
+                                size_t cap, size_t* out_len) {
+    const uint8_t* s = (const uint8_t*)str;
+    size_t i = 0, o = 0;
+    uint32_t cp;
+
+    UTF_CHECK_ARGS(s, len, out, cap, out_len);
+    while (i < len) {
+        if (len - i >= 16 && cap - o >= 16) {
+            // Widen all 16, keep what precedes the first non-ASCII byte
+            size_t k = ascii_prefix16(s + i);
+            *(u16x16_u*)(out + o) =
+                __builtin_convertvector(*(const vec16_u*)(s + i), u16x16);
+            i += k;
+            o += k;
+            if (k == 16) continue;
+        }
+        size_t n = utf8_decode(s + i, len - i, &cp);
+        if (n == 0) return utf_result(ECLIB_ECLIB_INVALID_ENCODING, o, out_len);
+        if (cp < 0x10000) {
+            if (o == cap) break;
+            out[o++] = (uint16_t)cp;
+        } else {
+            if (cap - o < 2) break;
+            cp -= 0x10000;
+            out[o++] = (uint16_t)(0xD800 | cp >> 10);
+            out[o++] = (uint16_t)(0xDC00 | (cp & 0x3FF));
+        }
+        i += n;
+    }
+    return utf_result(i < len ? ECLIB_ECLIB_BUFFER_TOO_SMALL : ECLIB_OK,
+                      o, out_len);
+}
+
+eclib_err_t eclib_utf8_to_utf32(const char* str, size_t len, uint32_t* out,
+                                size_t cap, size_t* out_len) {
+    const uint8_t* s = (const uint8_t*)str;
+    size_t i = 0, o = 0;
+    uint32_t cp;
+
+    UTF_CHECK_ARGS(s, len, out, cap, out_len);
+    while (i < len) {
+        if (len - i >= 16 && cap - o >= 16) {
+            size_t k = ascii_prefix16(s + i);
+            for (int j = 0; j < 16; j += 4) {
+                *(u32x4_u*)(out + o + j) =
+                    __builtin_convertvector(*(const u8x4_u*)(s + i + j), u32x4);
+            }
+            i += k;
+            o += k;
+            if (k == 16) continue;
+        }
+        size_t n = utf8_decode(s + i, len - i, &cp);
+        if (n == 0) return utf_result(ECLIB_ECLIB_INVALID_ENCODING, o, out_len);
+        if (o == cap) break;
+        out[o++] = cp;
+        i += n;
+    }
+    return utf_result(i < len ? ECLIB_ECLIB_BUFFER_TOO_SMALL : ECLIB_OK,
+                      o, out_len);
+}
+
+eclib_err_t eclib_utf16_to_utf8(const uint16_t* s, size_t len, char* out,
+                                size_t cap, size_t* out_len) {
+    uint8_t* d = (uint8_t*)out;
+    size_t i = 0, o = 0;
+
+    UTF_CHECK_ARGS(s, len, out, cap, out_len);
+    while (i < len) {
+        // Narrow eight units, keep the ASCII ones in front
+        if (len - i >= 8 && cap - o >= 8) {
+            uint64_t lo = *(const utils_u64*)(s + i) & ASCII_MASK16;
+            uint64_t hi = *(const utils_u64*)(s + i + 4) & ASCII_MASK16;
+            size_t k = lo ? (size_t)__builtin_ctzll(lo) >> 4
+                     : hi ? 4 + ((size_t)__builtin_ctzll(hi) >> 4) : 8;
+            *(u8x8_u*)(d + o) =
+                __builtin_convertvector(*(const u16x8_u*)(s + i), u8x8);
+            i += k;
+            o += k;
+            if (k == 8) continue;
+        }
+        uint32_t c = s[i];
+        size_t n = 1;
+        if (c >= 0xD800 && c <= 0xDFFF) {
+            // Needs a high then a low surrogate
+            if (c > 0xDBFF || len - i < 2 || s[i + 1] < 0xDC00 ||
+                s[i + 1] > 0xDFFF) {
+                return utf_result(ECLIB_ECLIB_INVALID_ENCODING, o, out_len);
+            }
+            c = 0x10000 + ((c - 0xD800) << 10) + (s[i + 1] - 0xDC00u);
+            n = 2;
+        }
+        size_t w = utf8_width(c);
+        if (cap - o < w) break;
+        utf8_encode(d + o, c);
+        o += w;
+        i += n;
+    }
+    return utf_result(i < len ? ECLIB_ECLIB_BUFFER_TOO_SMALL : ECLIB_OK,
+                      o, out_len);
+}
+
+eclib_err_t eclib_utf32_to_utf8(const uint32_t* s, size_t len, char* out,
+                                size_t cap, size_t* out_len) {
+    uint8_t* d = (uint8_t*)out;
+    size_t i = 0, o = 0;
+
+    UTF_CHECK_ARGS(s, len, out, cap, out_len);
+    for (; i < len; i++) {
+        uint32_t c = s[i];
+        if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+            return utf_result(ECLIB_ECLIB_INVALID_ENCODING, o, out_len);
+        }
+        size_t w = utf8_width(c);
+        if (cap - o < w) break;
+        utf8_encode(d + o, c);
+        o += w;
+    }
+    return utf_result(i < len ? ECLIB_ECLIB_BUFFER_TOO_SMALL : ECLIB_OK,
+                      o, out_len);
+}
+
+// --------------------------
+// Truncation
+// --------------------------
+// Where to cut s before byte n (s[n] readable) without splitting a
+// sequence: before the lead of the sequence s[n] belongs to
+static inline size_t utf8_cut(const uint8_t* s, size_t n) {
+    size_t k = n;
+
+    while (k > 0 && n - k < 3 && utf8_cont(s[k])) k--;
+    uint8_t c = s[k];
+    size_t need = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+    // A continuation with no lead in reach belongs to nothing
+    return (k < n && !utf8_cont(c) && n - k < need) ? k : n;
+}
+
+size_t eclib_utf8_truncate(const char* s, size_t len, size_t max) {
+    if (s == NULL) return 0;
+    if (len <= max) return len;
+    return utf8_cut((const uint8_t*)s, max);
+}
+
+char* eclib_utf8_strncpy(char* dest, const char* src, size_t max_len) {
+    if (dest == NULL || src == NULL || max_len == 0) {
+        return dest;
+    }
+    size_t n = eclib_strnlen(src, max_len);
+    // Too long: src[max_len - 1] exists and is where the cut would fall
+    if (n == max_len) n = utf8_cut((const uint8_t*)src, max_len - 1);
+    eclib_memcpy(dest, src, n);
+    dest[n] = '\0';
+    return dest;
+}
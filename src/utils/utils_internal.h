@@ -0,0 +1,132 @@
+/*
+ * ECLib - E-comOS C Library
+ * Copyright (C) 2025 E-comOS Kernel Mode Team & Saladin5101
+ *
+ * This file is part of ECLib.
+ * ECLib is free library; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ */
+// Private interface shared by the files under src/utils. Not installed.
+#ifndef ECLIB_UTILS_INTERNAL_H
+#define ECLIB_UTILS_INTERNAL_H
+#include <stdint.h>
+#include <stddef.h>
+
+// GCC turns plain copy/fill loops into calls to memcpy/memset, which do
+// not exist on E-comOS (and would recurse if they did). Every function
+// that implements one of them carries this.
+#define ECLIB_NO_LIBCALL \
+    __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+// Unaligned, aliasing-safe scalar access
+typedef uint64_t utils_u64 __attribute__((aligned(1), may_alias));
+typedef uint32_t utils_u32 __attribute__((aligned(1), may_alias));
+typedef uint16_t utils_u16 __attribute__((aligned(1), may_alias));
+typedef uint64_t utils_u64a __attribute__((may_alias));
+
+// GCC vector types for the SIMD variants: _a aligned, _u unaligned
+typedef uint8_t vec16_a __attribute__((vector_size(16), may_alias));
+typedef uint8_t vec16_u __attribute__((vector_size(16), aligned(1), may_alias));
+typedef uint8_t vec32_a __attribute__((vector_size(32), may_alias));
+typedef uint8_t vec32_u __attribute__((vector_size(32), aligned(1), may_alias));
+
+// Scanning functions read whole aligned vectors around the string, which
+// never crosses into another page but does touch bytes outside the object.
+#define UTILS_PAGE_SIZE     4096
+#define ECLIB_SCAN          __attribute__((no_sanitize_address))
+
+// CPU features (dispatch.c)
+#define UTILS_CPU_SSE2      0x0001
+#define UTILS_CPU_AVX2      0x0002
+#define UTILS_CPU_NEON      0x0004
+#define UTILS_CPU_SSE42     0x0008
+#define UTILS_CPU_CRC32     0x0010      // ARMv8 CRC32 instructions
+
+// Copies of at least this many bytes bypass the cache (dispatch.c sets it
+// from the size of the last-level cache when it can find out)
+#define UTILS_NT_DEFAULT    (4 * 1024 * 1024)
+
+// Every variant provides the same set of routines
+#define UTILS_DECLARE_VARIANT(sfx)                                            \
+    void* utils_memcpy_##sfx(void* dest, const void* src, size_t len);        \
+    void* utils_memmove_##sfx(void* dest, const void* src, size_t len);       \
+    void* utils_memset_##sfx(void* ptr, int value, size_t len);               \
+    size_t utils_strlen_##sfx(const char* s);                                 \
+    size_t utils_strnlen_##sfx(const char* s, size_t n);                      \
+    char* utils_strchr_##sfx(const char* s, int c);                           \
+    char* utils_strrchr_##sfx(const char* s, int c);                          \
+    int utils_strcmp_##sfx(const char* a, const char* b);                     \
+    int utils_strncmp_##sfx(const char* a, const char* b, size_t n);          \
+    void* utils_memchr_##sfx(const void* s, int c, size_t n);                 \
+    void* utils_memrchr_##sfx(const void* s, int c, size_t n);                \
+    int utils_memcmp_##sfx(const void* a, const void* b, size_t n);
+
+// Dispatch table: starts out pointing at the portable versions and is
+// switched to the best ones for this CPU by eclib_utils_init().
+typedef struct {
+    void* (*memcpy)(void* dest, const void* src, size_t len);
+    void* (*memmove)(void* dest, const void* src, size_t len);
+    void* (*memset)(void* ptr, int value, size_t len);
+    size_t (*strlen)(const char* s);
+    size_t (*strnlen)(const char* s, size_t n);
+    char* (*strchr)(const char* s, int c);
+    char* (*strrchr)(const char* s, int c);
+    int (*strcmp)(const char* a, const char* b);
+    int (*strncmp)(const char* a, const char* b, size_t n);
+    void* (*memchr)(const void* s, int c, size_t n);
+    void* (*memrchr)(const void* s, int c, size_t n);
+    int (*memcmp)(const void* a, const void* b, size_t n);
+    size_t (*setspn)(const char* s, const uint8_t* map, int in);
+    size_t (*setspn_mem)(const void* s, size_t n, const uint8_t* map, int in);
+    uint32_t (*crc32c)(uint32_t crc, const void* data, size_t len);
+    size_t (*utf8_check)(const uint8_t* s, size_t len);
+    size_t nt_threshold;
+    uint32_t cpu;
+} utils_ops_t;
+
+extern utils_ops_t g_utils_ops;
+
+// Variants (memops.c, strops.c)
+UTILS_DECLARE_VARIANT(generic)
+#if defined(__x86_64__)
+UTILS_DECLARE_VARIANT(sse2)
+UTILS_DECLARE_VARIANT(avx2)
+#elif defined(__aarch64__)
+UTILS_DECLARE_VARIANT(neon)
+#endif
+
+// Span of the bytes in (in) or not in (!in) an eclib_charset_t map;
+// the string form also stops at NUL (tokens.c). Only the variants with a
+// byte shuffle have their own.
+#define UTILS_DECLARE_SETSPN(sfx)                                             \
+    size_t utils_setspn_##sfx(const char* s, const uint8_t* map, int in);     \
+    size_t utils_setspn_mem_##sfx(const void* s, size_t n,                    \
+                                  const uint8_t* map, int in);
+
+UTILS_DECLARE_SETSPN(generic)
+#if defined(__x86_64__)
+UTILS_DECLARE_SETSPN(avx2)
+#elif defined(__aarch64__)
+UTILS_DECLARE_SETSPN(neon)
+#endif
+
+// CRC-32C of data continuing from register crc, no inversions (crc32c.c)
+uint32_t utils_crc32c_generic(uint32_t crc, const void* data, size_t len);
+#if defined(__x86_64__)
+uint32_t utils_crc32c_sse42(uint32_t crc, const void* data, size_t len);
+#elif defined(__aarch64__)
+uint32_t utils_crc32c_armv8(uint32_t crc, const void* data, size_t len);
+#endif
+
+// Length of the valid UTF-8 prefix of s (utf8.c). Only the variants with
+// a byte shuffle have their own.
+size_t utils_utf8_check_generic(const uint8_t* s, size_t len);
+#if defined(__x86_64__)
+size_t utils_utf8_check_avx2(const uint8_t* s, size_t len);
+#elif defined(__aarch64__)
+size_t utils_utf8_check_neon(const uint8_t* s, size_t len);
+#endif
+
+#endif // ECLIB_UTILS_INTERNAL_H